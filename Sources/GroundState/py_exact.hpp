@@ -97,7 +97,8 @@ void AddExactModule(py::module &m) {
                    other choices are `dense` and `direct`.
 
            )EOF")
-      .def("advance", &ExactTimePropagation::Advance, py::arg("dt"), R"EOF(
+      .def("advance", &ExactTimePropagation::Advance,
+           py::call_guard<py::gil_scoped_release>(), py::arg("dt"), R"EOF(
            Advance the time propagation by dt.
 
            Args:
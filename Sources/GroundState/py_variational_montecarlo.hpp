@@ -41,47 +41,49 @@ py::array_t<T, ExtraFlags> as_readonly(py::array_t<T, ExtraFlags> array) {
 void AddVariationalMonteCarloModule(py::module &m) {
   auto m_vmc = m.def_submodule("variational");
 
+  // The arrays below are views of the MCResult buffers. They keep the
+  // MCResult Python object alive through their base, so nothing is copied.
   py::class_<MCResult>(m_vmc, "MCResult",
                        R"EOF(Result of Monte Carlo sampling.)EOF")
       .def_property_readonly(
           "samples",
-          [](const MCResult &self) {
-            assert(self.samples.rows() % self.n_chains == 0);
+          [](py::object self) {
+            auto const &result = self.cast<const MCResult &>();
+            assert(result.samples.rows() % result.n_chains == 0);
             return detail::as_readonly(py::array_t<double, py::array::c_style>{
-                {self.samples.rows() / self.n_chains, self.n_chains,
-                 self.samples.cols()},
-                self.samples.data(),
-                py::none()});
+                {result.samples.rows() / result.n_chains, result.n_chains,
+                 result.samples.cols()},
+                result.samples.data(),
+                self});
           },
-          py::return_value_policy::reference_internal,
           R"EOF(Visible configurations `{vᵢ}` visited during sampling.)EOF")
       .def_property_readonly(
           "log_values",
-          [](const MCResult &self) {
-            assert(self.log_values.rows() % self.n_chains == 0);
+          [](py::object self) {
+            auto const &result = self.cast<const MCResult &>();
+            assert(result.log_values.rows() % result.n_chains == 0);
             return detail::as_readonly(py::array_t<Complex, py::array::c_style>{
-                {self.log_values.rows() / self.n_chains, self.n_chains},
-                self.log_values.data(),
-                py::none()});
+                {result.log_values.rows() / result.n_chains, result.n_chains},
+                result.log_values.data(),
+                self});
           },
-          py::return_value_policy::reference_internal,
           R"EOF(An array of `complex128` representing `Ψ(vᵢ)` for all
                 sampled visible configurations `vᵢ`.)EOF")
       .def_property_readonly(
           "der_logs",
-          [](const MCResult &self) -> py::object {
-            if (self.der_logs.has_value()) {
-              assert(self.der_logs->rows() % self.n_chains == 0);
+          [](py::object self) -> py::object {
+            auto const &result = self.cast<const MCResult &>();
+            if (result.der_logs.has_value()) {
+              assert(result.der_logs->rows() % result.n_chains == 0);
               return detail::as_readonly(
                   py::array_t<Complex, py::array::c_style>{
-                      {self.der_logs->rows() / self.n_chains, self.n_chains,
-                       self.der_logs->cols()},
-                      self.der_logs->data(),
-                      py::none()});
+                      {result.der_logs->rows() / result.n_chains,
+                       result.n_chains, result.der_logs->cols()},
+                      result.der_logs->data(),
+                      self});
             }
             return py::none();
           },
-          py::return_value_policy::reference_internal,
           R"EOF(A matrix of logarithmic derivatives.
 
                 Each row in the matrix corresponds to the gradient of
@@ -176,7 +178,8 @@ void AddVariationalMonteCarloModule(py::module &m) {
                ob_name: The name of the observable.
 
            )EOF")
-      .def("run", &VariationalMonteCarlo::Run, py::arg("output_prefix"),
+      .def("run", &VariationalMonteCarlo::Run,
+           py::call_guard<py::gil_scoped_release>(), py::arg("output_prefix"),
            py::arg("n_iter") = nonstd::nullopt, py::arg("step_size") = 1,
            py::arg("save_params_every") = 50, R"EOF(
            Optimize the Vmc wavefunction.
@@ -185,8 +188,11 @@ void AddVariationalMonteCarloModule(py::module &m) {
                output_prefix: The output file name, without extension.
                n_iter: The maximum number of iterations.
                step_size: Number of iterations performed at a time. Default is 1.
-               save_params_every: Frequency to dump wavefunction parameters. The
-                   default is 50.
+               save_params_every: Frequency to dump wavefunction parameters
+                   and the state of the sampler. The default is 50. The
+                   parameters are written to `output_prefix.wf` and the
+                   sampler state to `output_prefix.sampler` (one file
+                   `output_prefix.sampler.<rank>` per node with MPI).
 
            Examples:
                Running a simple Vmc calculation.
@@ -212,7 +218,17 @@ void AddVariationalMonteCarloModule(py::module &m) {
 
            )EOF")
       .def("reset", &VariationalMonteCarlo::Reset)
-      .def("advance", &VariationalMonteCarlo::Advance, py::arg("steps") = 1,
+      .def("load_sampler_state", &VariationalMonteCarlo::LoadSamplerState,
+           py::arg("filename"), R"EOF(
+           Restores the sampler from a state saved by `run`, so that an
+           interrupted calculation can be resumed with thermalized Markov
+           chains. The machine parameters should be loaded first.
+
+           Args:
+               filename: The sampler state file, `output_prefix.sampler`.
+           )EOF")
+      .def("advance", &VariationalMonteCarlo::Advance,
+           py::call_guard<py::gil_scoped_release>(), py::arg("steps") = 1,
            R"EOF(
            Perform one or several iteration steps of the VMC calculation. In each step,
            energy and gradient will be estimated via VMC and subsequently, the variational
@@ -225,7 +241,10 @@ void AddVariationalMonteCarloModule(py::module &m) {
       .def(
           "get_observable_stats",
           [](VariationalMonteCarlo &self) {
-            self.ComputeObservables();
+            {
+              py::gil_scoped_release release;
+              self.ComputeObservables();
+            }
             return self.GetObservableStats();
           },
           R"EOF(
@@ -233,6 +252,33 @@ void AddVariationalMonteCarloModule(py::module &m) {
 
         )EOF")
       .def_property_readonly("vmc_data", &VariationalMonteCarlo::GetVmcData)
+      .def_property(
+          "target_autocorrelation",
+          [](const VariationalMonteCarlo &self) {
+            return self.GetThinning().Target();
+          },
+          &VariationalMonteCarlo::SetTargetAutocorrelation,
+          R"EOF(Optional[float]: Target integrated autocorrelation time of the
+                stored samples. If set, the number of sweeps between two
+                stored samples and the number of discarded sweeps are adapted
+                after every iteration, and reported in the "Sampling" entry
+                of the log. `None` (the default) disables the adaptation.)EOF")
+      .def_property_readonly(
+          "thinning",
+          [](const VariationalMonteCarlo &self) {
+            return self.GetThinning().Thinning();
+          },
+          R"EOF(int: Number of sweeps between two stored samples.)EOF")
+      .def_property_readonly(
+          "n_discard", &VariationalMonteCarlo::GetDiscard,
+          R"EOF(int: Number of sweeps discarded before sampling.)EOF")
+      .def_property(
+          "persistent_chains", &VariationalMonteCarlo::PersistentChains,
+          &VariationalMonteCarlo::SetPersistentChains,
+          R"EOF(bool: Whether Markov chains continue from one iteration to
+                the next without being thermalized again. If `True`, the
+                discarded samples are only discarded in the first iteration
+                (and after `reset`). The default is `False`.)EOF")
       .def_property(
           "store_rank",
           [](VariationalMonteCarlo &self) -> nonstd::optional<bool> {
@@ -312,9 +358,10 @@ void AddVariationalMonteCarloModule(py::module &m) {
                 Becca and Sorella (2017), pp. 143-144.
                 https://doi.org/10.1017/9781316417041")EOF");
 
-  m_vmc.def("compute_samples", &ComputeSamples, py::arg{"sampler"},
+  m_vmc.def("compute_samples", &ComputeSamples,
+            py::call_guard<py::gil_scoped_release>(), py::arg{"sampler"},
             py::arg{"n_samples"}, py::arg{"n_discard"},
-            py::arg{"der_logs"} = py::none(),
+            py::arg{"der_logs"} = py::none(), py::arg{"n_thin"} = 1,
             R"EOF(Runs Monte Carlo sampling using `sampler`.
 
                   First `n_discard` sweeps are discarded. Results of the next
@@ -324,8 +371,9 @@ void AddVariationalMonteCarloModule(py::module &m) {
                   away useful data, of course). You can rely on
                   `compute_samples` to return at least `n_samples` samples.
 
-                  Exact number of performed sweeps and samples stored can be
-                  computed using the following functions:
+                  Exact number of recorded batches and samples stored can be
+                  computed using the following functions (`n_thin` sweeps
+                  are performed between two recorded batches):
 
                   ```python
 
@@ -344,6 +392,8 @@ void AddVariationalMonteCarloModule(py::module &m) {
                           of the wave function. `None` means don't compute,
                           "normal" means compute, and "centered" means compute
                           and then center.
+                      n_thin: number of sweeps between two recorded batches
+                          of samples.
 
                   Returns:
                       A `MCResult` object with all the data obtained during sampling.)EOF");
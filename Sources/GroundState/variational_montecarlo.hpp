@@ -29,6 +29,7 @@
 #include "Optimizer/stochastic_reconfiguration.hpp"
 #include "Output/json_output_writer.hpp"
 #include "Sampler/abstract_sampler.hpp"
+#include "Sampler/thinning_controller.hpp"
 #include "Sampler/vmc_sampling.hpp"
 #include "Stats/mc_stats.hpp"
 #include "Utils/parallel_utils.hpp"
@@ -76,6 +77,15 @@ class VariationalMonteCarlo {
   int ninitsamples_;
   int ndiscard_;
 
+  // Adapts the thinning and ndiscard_ to the autocorrelation time (disabled
+  // by default)
+  ThinningController thinning_;
+
+  // If true, Markov chains are only thermalized once and then continue from
+  // one iteration to the next
+  bool persistent_chains_;
+  bool thermalized_;
+
   int npar_;
 
   std::string target_;
@@ -96,6 +106,8 @@ class VariationalMonteCarlo {
         psi_(sampler.GetMachine()),
         opt_(optimizer),
         sr_{nonstd::nullopt},
+        persistent_chains_(false),
+        thermalized_(false),
         target_(target) {
     Init(nsamples, discarded_samples, discarded_samples_on_init, method,
          diag_shift, use_iterative, use_cholesky, sr_lsq_solver);
@@ -174,6 +186,7 @@ class VariationalMonteCarlo {
 
   void Reset() {
     opt_.Reset();
+    thermalized_ = false;
     InitSweeps();
   }
 
@@ -185,7 +198,8 @@ class VariationalMonteCarlo {
     for (std::size_t i = 0; i < obs_.size(); ++i) {
       auto local_values = LocalValues(mc_data_.samples, mc_data_.log_values,
                                       psi_, *obs_[i], sampler_.BatchSize());
-      auto stats = Statistics(local_values, mc_data_.n_chains);
+      auto stats = Statistics(local_values, mc_data_.n_chains,
+                              sampler_.SharesChains());
       observable_stats_[obsnames_[i]] = stats;
     }
   }
@@ -196,15 +210,19 @@ class VariationalMonteCarlo {
   void Advance(Index steps = 1) {
     assert(steps > 0);
     for (Index i = 0; i < steps; ++i) {
-      mc_data_ = ComputeSamples(sampler_, nsamples_node_, ndiscard_,
-                                /*der_logs=*/"centered");
+      mc_data_ = ComputeSamples(sampler_, nsamples_node_, GetDiscard(),
+                                /*der_logs=*/"centered", thinning_.Thinning());
+      thermalized_ = true;
 
       const auto local_values =
           LocalValues(mc_data_.samples, mc_data_.log_values, psi_, ham_,
                       sampler_.BatchSize());
-      const auto stats = Statistics(local_values, mc_data_.n_chains);
+      const auto stats = Statistics(local_values, mc_data_.n_chains,
+                                    sampler_.SharesChains());
 
       observable_stats_["Energy"] = stats;
+      thinning_.Update(stats, local_values, mc_data_.n_chains,
+                       sampler_.SharesChains());
 
       if (target_ == "energy") {
         assert(mc_data_.der_logs.has_value());
@@ -242,10 +260,19 @@ class VariationalMonteCarlo {
       // written once
       if (writer.has_value()) {
         auto obs_data = json(observable_stats_);
+        if (thinning_.IsEnabled()) {
+          obs_data["Sampling"] = json{{"Thinning", thinning_.Thinning()},
+                                      {"Discarded", thinning_.Discard()}};
+        }
 
         writer->WriteLog(step, obs_data);
         writer->WriteState(step, psi_);
       }
+      // Every process saves its own Markov chains, so that the run can be
+      // resumed without thermalizing them again (see #LoadSamplerState())
+      if (step % save_params_every == 0) {
+        sampler_.SaveState(output_prefix + ".sampler");
+      }
       MPI_Barrier(MPI_COMM_WORLD);
     }
   }
@@ -273,6 +300,50 @@ class VariationalMonteCarlo {
 
   AbstractMachine &GetMachine() { return psi_; }
 
+  /// \brief Sets the target autocorrelation time of the samples.
+  ///
+  /// The thinning and the number of discarded sweeps are then adapted
+  /// between iterations (see ThinningController). `nullopt` restores the
+  /// fixed number of discarded sweeps and no thinning.
+  void SetTargetAutocorrelation(nonstd::optional<double> tau) {
+    thinning_.SetTarget(tau, ndiscard_);
+  }
+
+  const ThinningController &GetThinning() const noexcept { return thinning_; }
+
+  /// Number of sweeps discarded before sampling in the next iteration.
+  Index GetDiscard() const noexcept {
+    if (persistent_chains_ && thermalized_) {
+      // The chains are already thermalized, only the last recorded samples
+      // of the previous iteration are skipped
+      return thinning_.Thinning();
+    }
+    return thinning_.IsEnabled() ? thinning_.Discard() : Index{ndiscard_};
+  }
+
+  /// \brief Enables or disables persistent Markov chains.
+  ///
+  /// Samplers keep their configurations between iterations and
+  /// AbstractSampler::Reset() only refreshes the log-values and look-up tables
+  /// for the new parameters. With persistent chains, the discarded sweeps are
+  /// thus only performed in the first iteration (and after #Reset()), since
+  /// parameters only change slightly from one iteration to the next.
+  void SetPersistentChains(bool persistent) noexcept {
+    persistent_chains_ = persistent;
+  }
+
+  bool PersistentChains() const noexcept { return persistent_chains_; }
+
+  /// \brief Restores the sampler from a checkpoint written by #Run().
+  ///
+  /// The chains are considered thermalized, so with persistent chains no
+  /// sweeps are discarded in the next iteration. The parameters of the
+  /// machine should be loaded beforehand. Must be called by all processes.
+  void LoadSamplerState(const std::string &filename) {
+    sampler_.LoadState(filename);
+    thermalized_ = true;
+  }
+
   const StatsMap &GetObservableStats() const noexcept {
     return observable_stats_;
   }
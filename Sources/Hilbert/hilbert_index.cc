@@ -75,7 +75,15 @@ std::size_t HilbertIndex::DeltaStateToNumber(
 
 // converts an integer into a vector of quantum numbers
 Eigen::VectorXd HilbertIndex::NumberToState(int i) const {
-  Eigen::VectorXd result = Eigen::VectorXd::Constant(size_, localstates_[0]);
+  Eigen::VectorXd result(size_);
+  NumberToState(i, result);
+  return result;
+}
+
+void HilbertIndex::NumberToState(int i,
+                                 Eigen::Ref<Eigen::VectorXd> out) const {
+  assert(out.size() == size_);
+  out.setConstant(localstates_[0]);
 
   int ip = i;
 
@@ -83,11 +91,10 @@ Eigen::VectorXd HilbertIndex::NumberToState(int i) const {
 
   while (ip > 0) {
     assert(static_cast<std::size_t>(ip % localsize_) < localstates_.size());
-    result(k) = localstates_[ip % localsize_];
+    out(k) = localstates_[ip % localsize_];
     ip /= localsize_;
     k--;
   }
-  return result;
 }
 
 constexpr int HilbertIndex::MaxStates;
@@ -43,6 +43,10 @@ class HilbertIndex {
   // converts an integer into a vector of quantum numbers
   Eigen::VectorXd NumberToState(int i) const;
 
+  // same as above, but writes the quantum numbers into out (which must have
+  // the right size) instead of allocating a new vector
+  void NumberToState(int i, Eigen::Ref<Eigen::VectorXd> out) const;
+
   /*constexpr*/ int NStates() const noexcept { return nstates_; }
   constexpr static int MaxStates = std::numeric_limits<int>::max() - 1;
 
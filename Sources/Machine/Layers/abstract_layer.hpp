@@ -118,6 +118,15 @@ class AbstractLayer {
   */
   virtual void Forward(const VectorType &input, VectorType &output) = 0;
 
+  /**
+  Member function to feedforward a batch of inputs through the layer.
+  @param input a constant reference to the inputs to the layer, a matrix of
+  size Ninput() x batch_size where each column is an input.
+  @param output reference to the output matrix, resized to
+  Noutput() x batch_size.
+  */
+  virtual void Forward(const MatrixType &input, MatrixType &output) = 0;
+
   /**
   Member function to perform backpropagation to compute derivates.
   @param prev_layer_output a constant reference to the output from previous
@@ -137,6 +146,25 @@ class AbstractLayer {
                         const VectorType &dout, VectorType &din,
                         VectorRefType der) = 0;
 
+  /**
+  Member function to perform backpropagation for a batch of inputs. All
+  matrices store one sample per column, in the same order as the inputs given
+  to the batched Forward.
+  @param prev_layer_output a constant reference to the outputs from previous
+  layer.
+  @param this_layer_output a constant reference to the outputs from the
+  current layer.
+  @param dout a constant reference to the derivatives dL/dA.
+  @param din reference to the derivatives with respect to the inputs of the
+  current layer, resized to Ninput() x batch_size.
+  @param der a Npar() x batch_size matrix where the derivatives wrt to the
+  parameters in the layer are written.
+  */
+  virtual void Backprop(const MatrixType &prev_layer_output,
+                        const MatrixType &this_layer_output,
+                        const MatrixType &dout, MatrixType &din,
+                        Eigen::Ref<MatrixType> der) = 0;
+
   virtual void to_json(nlohmann::json &j) const = 0;
 
   virtual void from_json(const nlohmann::json &j) = 0;
@@ -70,12 +70,10 @@ class Activation : public AbstractLayer {
                     const VectorType &new_input, const VectorType & /*output*/,
                     std::vector<int> &output_changes,
                     VectorType &new_output) override {
+    // The activation acts element-wise, so only the changed inputs have to be
+    // propagated
     const int num_of_changes = input_changes.size();
-    if (num_of_changes == size_) {
-      output_changes.resize(size_);
-      new_output.resize(size_);
-      activation_.operator()(new_input, new_output);
-    } else if (num_of_changes > 0) {
+    if (num_of_changes > 0) {
       output_changes = input_changes;
       new_output.resize(num_of_changes);
       activation_.operator()(new_input, new_output);
@@ -90,6 +88,15 @@ class Activation : public AbstractLayer {
     activation_.operator()(input, output);
   }
 
+  // Activations act element-wise, so the whole batch is processed as one
+  // long vector
+  void Forward(const MatrixType &input, MatrixType &output) override {
+    output.resize(size_, input.cols());
+    Eigen::Map<VectorType> flat_output(output.data(), output.size());
+    activation_.operator()(
+        Eigen::Map<const VectorType>(input.data(), input.size()), flat_output);
+  }
+
   // Computes derivative.
   void Backprop(const VectorType &prev_layer_output,
                 const VectorType &this_layer_output, const VectorType &dout,
@@ -97,6 +104,19 @@ class Activation : public AbstractLayer {
     din.resize(size_);
     activation_.ApplyJacobian(prev_layer_output, this_layer_output, dout, din);
   }
+
+  void Backprop(const MatrixType &prev_layer_output,
+                const MatrixType &this_layer_output, const MatrixType &dout,
+                MatrixType &din, Eigen::Ref<MatrixType> /*der*/) override {
+    din.resize(size_, dout.cols());
+    Eigen::Map<VectorType> flat_din(din.data(), din.size());
+    activation_.ApplyJacobian(
+        Eigen::Map<const VectorType>(prev_layer_output.data(),
+                                     prev_layer_output.size()),
+        Eigen::Map<const VectorType>(this_layer_output.data(),
+                                     this_layer_output.size()),
+        Eigen::Map<const VectorType>(dout.data(), dout.size()), flat_din);
+  }
 };
 }  // namespace netket
 
@@ -18,6 +18,7 @@
 #include <Eigen/Dense>
 #include <complex>
 #include <fstream>
+#include <numeric>
 #include <random>
 #include <string>
 #include <vector>
@@ -42,6 +43,12 @@ class FullyConnected : public AbstractLayer {
 
   std::size_t scalar_bytesize_;
 
+  // Fraction of changed inputs above which UpdateLookup recomputes the
+  // output from scratch
+  static constexpr double incremental_cutoff_ = 0.5;
+
+  VectorType input_buffer_;
+
  public:
   /// Constructor
   FullyConnected(const int input_size, const int output_size,
@@ -138,17 +145,27 @@ class FullyConnected : public AbstractLayer {
                     std::vector<int> &output_changes,
                     VectorType &new_output) override {
     const int num_of_changes = input_changes.size();
-    if (num_of_changes == in_size_) {
-      output_changes.resize(out_size_);
-      new_output.resize(out_size_);
-      Forward(new_input, new_output);
-    } else if (num_of_changes > 0) {
-      output_changes.resize(out_size_);
+    if (num_of_changes == 0) {
+      output_changes.resize(0);
+      new_output.resize(0);
+      return;
+    }
+
+    // Every output depends on every input
+    output_changes.resize(out_size_);
+    std::iota(output_changes.begin(), output_changes.end(), 0);
+
+    // A rank-k update of the output costs k * out_size_ operations, while
+    // recomputing it costs in_size_ * out_size_ but runs as a contiguous GEMV
+    if (num_of_changes < incremental_cutoff_ * in_size_) {
       new_output = output;
       UpdateOutput(input, input_changes, new_input, new_output);
     } else {
-      output_changes.resize(0);
-      new_output.resize(0);
+      input_buffer_ = input;
+      for (int s = 0; s < num_of_changes; ++s) {
+        input_buffer_(input_changes[s]) = new_input(s);
+      }
+      Forward(input_buffer_, new_output);
     }
   }
 
@@ -158,6 +175,11 @@ class FullyConnected : public AbstractLayer {
     output.noalias() += weight_.transpose() * input;
   }
 
+  void Forward(const MatrixType &input, MatrixType &output) override {
+    output = bias_.replicate(1, input.cols());
+    output.noalias() += weight_.transpose() * input;
+  }
+
   // Updates theta given the input v, the change in the input (input_changes and
   // prev_input)
   inline void UpdateOutput(const VectorType &v,
@@ -195,6 +217,26 @@ class FullyConnected : public AbstractLayer {
     // Compute d(L) / d_in = W * [d(L) / d(z)]
     din.noalias() = weight_ * dout;
   }
+
+  void Backprop(const MatrixType &prev_layer_output,
+                const MatrixType & /*this_layer_output*/,
+                const MatrixType &dout, MatrixType &din,
+                Eigen::Ref<MatrixType> der) override {
+    int k = 0;
+
+    if (usebias_) {
+      der.topRows(out_size_) = dout;
+      k += out_size_;
+    }
+
+    // d(L) / d(W) is an outer product, so it has to be done sample by sample
+    for (Index b = 0; b < dout.cols(); ++b) {
+      Eigen::Map<MatrixType> der_w{&der(k, b), in_size_, out_size_};
+      der_w.noalias() = prev_layer_output.col(b) * dout.col(b).transpose();
+    }
+
+    din.noalias() = weight_ * dout;
+  }
 };
 }  // namespace netket
 
@@ -21,6 +21,7 @@
 #include <complex>
 #include <fstream>
 #include <memory>
+#include <numeric>
 #include <random>
 #include <vector>
 
@@ -62,10 +63,29 @@ class ConvolutionalHypercube : public AbstractLayer {
 
   std::string name_;
 
+  // lowered_index_[i * in_channels_ * kernel_size_ + in * kernel_size_ + k]
+  // is the position in the input of the k-th kernel element of channel in
+  // contributing to output node i
+  std::vector<int> lowered_index_;
+  // lowered_der_index_[i * out_channels_ * kernel_size_ + out * kernel_size_ +
+  // k] is the position in the output image through which input node i
+  // contributes to channel out via kernel(k), or -1 if there is none
+  std::vector<int> lowered_der_index_;
+
   MatrixType lowered_image_;
-  MatrixType lowered_image2_;
   MatrixType lowered_der_;
   MatrixType flipped_kernels_;
+  MatrixType lowered_output_;
+
+  // Fraction of changed inputs (and of affected output nodes) above which
+  // UpdateLookup switches from the sparse to the dense update
+  static constexpr double incremental_cutoff_ = 0.5;
+
+  VectorType input_buffer_;
+  // Output nodes affected by the current change and their position in
+  // affected_nodes_ (-1 if not affected)
+  std::vector<int> affected_nodes_;
+  std::vector<int> node_position_;
 
  public:
   /// Constructor
@@ -151,11 +171,33 @@ class ConvolutionalHypercube : public AbstractLayer {
       flipped_nodes_.push_back(flippednodes);
     }
 
+    lowered_index_.resize(nout_ * in_channels_ * kernel_size_);
+    for (int i = 0; i < nout_; ++i) {
+      for (int in = 0; in < in_channels_; ++in) {
+        for (int k = 0; k < kernel_size_; ++k) {
+          lowered_index_[(i * in_channels_ + in) * kernel_size_ + k] =
+              in * nv_ + neighbours_[i][k];
+        }
+      }
+    }
+
+    lowered_der_index_.resize(nv_ * out_channels_ * kernel_size_);
+    for (int i = 0; i < nv_; ++i) {
+      for (int out = 0; out < out_channels_; ++out) {
+        for (int k = 0; k < kernel_size_; ++k) {
+          const int n = flipped_nodes_[i][k];
+          lowered_der_index_[(i * out_channels_ + out) * kernel_size_ + k] =
+              n >= 0 ? out * nout_ + n : -1;
+        }
+      }
+    }
+
+    node_position_.assign(nout_, -1);
+
     kernels_.resize(in_channels_ * kernel_size_, out_channels_);
     bias_.resize(out_channels_);
 
     lowered_image_.resize(in_channels_ * kernel_size_, nout_);
-    lowered_image2_.resize(nout_, in_channels_ * kernel_size_);
     lowered_der_.resize(kernel_size_ * out_channels_, nv_);
     flipped_kernels_.resize(kernel_size_ * out_channels_, in_channels_);
 
@@ -226,71 +268,159 @@ class ConvolutionalHypercube : public AbstractLayer {
                     const VectorType &new_input, const VectorType &output,
                     std::vector<int> &output_changes,
                     VectorType &new_output) override {
-    // At the moment the light cone structure of the convolution is not
-    // exploited. To do so we would to change the part
-    // else if (num_of_changes >0) {...}
     const int num_of_changes = input_changes.size();
-    if (num_of_changes == in_size_) {
+    if (num_of_changes == 0) {
+      output_changes.resize(0);
+      new_output.resize(0);
+      return;
+    }
+
+    // Recomputing the convolution is done with a single GEMM, which beats
+    // the incremental update when a large part of the input has changed
+    if (num_of_changes >= incremental_cutoff_ * in_size_) {
+      input_buffer_ = input;
+      for (int s = 0; s < num_of_changes; ++s) {
+        input_buffer_(input_changes[s]) = new_input(s);
+      }
       output_changes.resize(out_size_);
+      std::iota(output_changes.begin(), output_changes.end(), 0);
       new_output.resize(out_size_);
-      Forward(new_input, new_output);
-    } else if (num_of_changes > 0) {
+      Forward(input_buffer_, new_output);
+      return;
+    }
+
+    // Only the output nodes in the light cone of the changed inputs are
+    // affected
+    for (int s = 0; s < num_of_changes; ++s) {
+      const int site = input_changes[s] % nv_;
+      for (auto n : flipped_nodes_[site]) {
+        if (n >= 0 && node_position_[n] < 0) {
+          node_position_[n] = affected_nodes_.size();
+          affected_nodes_.push_back(n);
+        }
+      }
+    }
+    const int num_affected = affected_nodes_.size();
+
+    if (num_affected < incremental_cutoff_ * nout_) {
+      // Only the affected nodes are passed on to the next layer
+      output_changes.resize(num_affected * out_channels_);
+      new_output.resize(num_affected * out_channels_);
+      for (int out = 0; out < out_channels_; ++out) {
+        for (int p = 0; p < num_affected; ++p) {
+          const int node = out * nout_ + affected_nodes_[p];
+          output_changes[out * num_affected + p] = node;
+          new_output(out * num_affected + p) = output(node);
+        }
+      }
+      UpdateOutput(input, input_changes, new_input, num_affected, new_output);
+    } else {
       output_changes.resize(out_size_);
+      std::iota(output_changes.begin(), output_changes.end(), 0);
       new_output = output;
-      UpdateOutput(input, input_changes, new_input, new_output);
-    } else {
-      output_changes.resize(0);
-      new_output.resize(0);
+      UpdateOutput(input, input_changes, new_input, -1, new_output);
+    }
+
+    for (auto n : affected_nodes_) {
+      node_position_[n] = -1;
     }
+    affected_nodes_.clear();
   }
 
   // Feedforward
   void Forward(const VectorType &input, VectorType &output) override {
-    Convolve(input, output);
+    Convolve(input.data(), 1, output.data());
+  }
 
-    if (usebias_) {
-      int k = 0;
-      for (int out = 0; out < out_channels_; ++out) {
-        for (int i = 0; i < nout_; ++i) {
-          output(k) += bias_(out);
-          ++k;
+  void Forward(const MatrixType &input, MatrixType &output) override {
+    output.resize(out_size_, input.cols());
+    Convolve(input.data(), input.cols(), output.data());
+  }
+
+  // performs the convolution of the kernel onto nsamples images stored
+  // contiguously at image and writes the results contiguously into z
+  inline void Convolve(const Complex *image, Index nsamples, Complex *z) {
+    // im2col method: all samples are lowered into a single matrix, so that
+    // the whole batch is done with one GEMM
+    Lower(image, nsamples, lowered_image_);
+    lowered_output_.noalias() = lowered_image_.transpose() * kernels_;
+    for (Index b = 0; b < nsamples; ++b) {
+      Eigen::Map<MatrixType> output_image(z + b * out_size_, nout_,
+                                          out_channels_);
+      output_image = lowered_output_.middleRows(b * nout_, nout_);
+      if (usebias_) {
+        output_image.rowwise() += bias_.transpose();
+      }
+    }
+  }
+
+  // im2col: column b * nout_ + i of lowered contains all the inputs of sample
+  // b which contribute to output node i
+  inline void Lower(const Complex *image, Index nsamples, MatrixType &lowered) {
+    const int rows = in_channels_ * kernel_size_;
+    lowered.resize(rows, nout_ * nsamples);
+    for (Index b = 0; b < nsamples; ++b) {
+      const Complex *sample = image + b * in_size_;
+      for (int i = 0; i < nout_; ++i) {
+        Complex *column = lowered.data() + (b * nout_ + i) * rows;
+        const int *index = lowered_index_.data() + i * rows;
+        for (int r = 0; r < rows; ++r) {
+          column[r] = sample[index[r]];
         }
       }
-    };
+    }
   }
 
-  // performs the convolution of the kernel onto the image and writes into z
-  inline void Convolve(const VectorType &image, VectorType &z) {
-    // im2col method
-    for (int i = 0; i < nout_; ++i) {
-      int j = 0;
-      for (auto n : neighbours_[i]) {
-        for (int in = 0; in < in_channels_; ++in) {
-          lowered_image_(in * kernel_size_ + j, i) = image(in * nv_ + n);
+  // Lowers d(L)/d(z) of nsamples outputs such that d(L)/d(in) becomes a GEMM
+  // with the flipped kernels
+  inline void LowerDer(const Complex *dout, Index nsamples,
+                       MatrixType &lowered) {
+    const int rows = out_channels_ * kernel_size_;
+    lowered.resize(rows, nv_ * nsamples);
+    for (Index b = 0; b < nsamples; ++b) {
+      const Complex *sample = dout + b * out_size_;
+      for (int i = 0; i < nv_; ++i) {
+        Complex *column = lowered.data() + (b * nv_ + i) * rows;
+        const int *index = lowered_der_index_.data() + i * rows;
+        for (int r = 0; r < rows; ++r) {
+          column[r] = index[r] >= 0 ? sample[index[r]] : Complex{0.0, 0.0};
         }
-        j++;
       }
     }
-    Eigen::Map<MatrixType> output_image(z.data(), nout_, out_channels_);
-    output_image.noalias() = lowered_image_.transpose() * kernels_;
   }
 
+  inline void FlipKernels() {
+    for (int out = 0; out < out_channels_; ++out) {
+      for (int in = 0; in < in_channels_; ++in) {
+        flipped_kernels_.block(out * kernel_size_, in, kernel_size_, 1) =
+            kernels_.block(in * kernel_size_, out, kernel_size_, 1);
+      }
+    }
+  }
+
+  // Adds the change of the convolution due to the changed inputs to
+  // new_output. If num_affected < 0, new_output is the whole output image,
+  // otherwise it only holds the num_affected nodes listed in affected_nodes_
+  // for every output channel.
   inline void UpdateOutput(const VectorType &v,
                            const std::vector<int> &input_changes,
-                           const VectorType &new_input,
+                           const VectorType &new_input, int num_affected,
                            VectorType &new_output) {
     const int num_of_changes = input_changes.size();
     for (int s = 0; s < num_of_changes; ++s) {
       const int sf = input_changes[s];
-      int kout = 0;
+      const int in = sf / nv_;
+      const auto &nodes = flipped_nodes_[sf % nv_];
+      const Complex delta = new_input(s) - v(sf);
       for (int out = 0; out < out_channels_; ++out) {
         for (int k = 0; k < kernel_size_; ++k) {
-          if (flipped_nodes_[sf][k] >= 0) {
-            new_output(flipped_nodes_[sf][k] + kout) +=
-                kernels_(k, out) * (new_input(s) - v(sf));
+          if (nodes[k] >= 0) {
+            const int pos = num_affected < 0
+                                ? out * nout_ + nodes[k]
+                                : out * num_affected + node_position_[nodes[k]];
+            new_output(pos) += kernels_(in * kernel_size_ + k, out) * delta;
           }
         }
-        kout += nout_;
       }
     }
   }
@@ -299,63 +429,55 @@ class ConvolutionalHypercube : public AbstractLayer {
                 const VectorType & /*this_layer_output*/,
                 const VectorType &dout, VectorType &din,
                 VectorRefType der) override {
-    // VectorType dLz = dout;
+    din.resize(in_size_);
+    BackpropImpl(prev_layer_output.data(), dout.data(), 1, din.data(),
+                 der.data(), der.size());
+  }
+
+  void Backprop(const MatrixType &prev_layer_output,
+                const MatrixType & /*this_layer_output*/,
+                const MatrixType &dout, MatrixType &din,
+                Eigen::Ref<MatrixType> der) override {
+    din.resize(in_size_, dout.cols());
+    BackpropImpl(prev_layer_output.data(), dout.data(), dout.cols(),
+                 din.data(), der.data(), der.outerStride());
+  }
+
+  // Derivatives for sample b are written to der + b * der_stride
+  inline void BackpropImpl(const Complex *prev_layer_output,
+                           const Complex *dout, Index nsamples, Complex *din,
+                           Complex *der, Index der_stride) {
     int kd = 0;
 
     // Derivative for bias, d(L) / d(b) = d(L) / d(z)
     if (usebias_) {
-      int k = 0;
-      for (int out = 0; out < out_channels_; ++out) {
-        der(kd) = 0;
-        for (int i = 0; i < nout_; ++i) {
-          der(kd) += dout(k);
-          ++k;
-        }
-        ++kd;
+      for (Index b = 0; b < nsamples; ++b) {
+        Eigen::Map<const MatrixType> dLz(dout + b * out_size_, nout_,
+                                         out_channels_);
+        Eigen::Map<VectorType>(der + b * der_stride, out_channels_) =
+            dLz.colwise().sum().transpose();
       }
+      kd += out_channels_;
     }
 
     // Derivative for weights, d(L) / d(W) = [d(L) / d(z)] * in'
-    // Reshape dLdZ
-    Eigen::Map<const MatrixType> dLz_reshaped(dout.data(), nout_,
-                                              out_channels_);
-
-    // Reshape image
-    for (int in = 0; in < in_channels_; ++in) {
-      for (int k = 0; k < kernel_size_; ++k) {
-        for (int i = 0; i < nout_; ++i) {
-          lowered_image2_(i, k + in * kernel_size_) =
-              prev_layer_output(in * nv_ + neighbours_[i][k]);
-        }
-      }
+    Lower(prev_layer_output, nsamples, lowered_image_);
+    for (Index b = 0; b < nsamples; ++b) {
+      Eigen::Map<const MatrixType> dLz(dout + b * out_size_, nout_,
+                                       out_channels_);
+      Eigen::Map<MatrixType> der_w(der + b * der_stride + kd,
+                                   in_channels_ * kernel_size_, out_channels_);
+      der_w.noalias() = lowered_image_.middleCols(b * nout_, nout_) * dLz;
     }
-    Eigen::Map<MatrixType> der_w(der.data() + kd, in_channels_ * kernel_size_,
-                                 out_channels_);
-    der_w.noalias() = lowered_image2_.transpose() * dLz_reshaped;
 
     // Compute d(L) / d_in = W * [d(L) / d(z)]
-    // int kout = 0;
-    for (int out = 0; out < out_channels_; ++out) {
-      for (int in = 0; in < in_channels_; ++in) {
-        flipped_kernels_.block(out * kernel_size_, in, kernel_size_, 1) =
-            kernels_.block(in * kernel_size_, out, kernel_size_, 1);
-      }
+    FlipKernels();
+    LowerDer(dout, nsamples, lowered_der_);
+    lowered_output_.noalias() = lowered_der_.transpose() * flipped_kernels_;
+    for (Index b = 0; b < nsamples; ++b) {
+      Eigen::Map<MatrixType>(din + b * in_size_, nv_, in_channels_) =
+          lowered_output_.middleRows(b * nv_, nv_);
     }
-
-    for (int i = 0; i < nv_; i++) {
-      int j = 0;
-      for (auto n : flipped_nodes_[i]) {
-        for (int out = 0; out < out_channels_; ++out) {
-          lowered_der_(out * kernel_size_ + j, i) =
-              n >= 0 ? dout(out * nout_ + n) : 0;
-        }
-        j++;
-      }
-    }
-
-    din.resize(in_size_);
-    Eigen::Map<MatrixType> der_in(din.data(), nv_, in_channels_);
-    der_in.noalias() = lowered_der_.transpose() * flipped_kernels_;
   }
 
   void to_json(json &pars) const override {
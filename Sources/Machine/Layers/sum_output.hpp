@@ -98,6 +98,10 @@ class SumOutput : public AbstractLayer {
     output(0) = input.sum();
   }
 
+  void Forward(const MatrixType &input, MatrixType &output) override {
+    output = input.colwise().sum();
+  }
+
   inline void UpdateOutput(const VectorType &v,
                            const std::vector<int> &input_changes,
                            const VectorType &new_input,
@@ -117,6 +121,13 @@ class SumOutput : public AbstractLayer {
     din.setConstant(dout(0));
   }
 
+  void Backprop(const MatrixType & /*prev_layer_output*/,
+                const MatrixType & /*this_layer_output*/,
+                const MatrixType &dout, MatrixType &din,
+                Eigen::Ref<MatrixType> /*der*/) override {
+    din = dout.row(0).replicate(in_size_, 1);
+  }
+
   void to_json(json &pars) const override {
     json layerpar;
     layerpar["Name"] = "Sum";
@@ -112,6 +112,43 @@ AbstractMachine::VectorType AbstractMachine::LogValDiff(
   return x;
 }
 
+any AbstractMachine::InitLookupBatch(Eigen::Ref<const RowMatrix<double>> v) {
+  CheckShape(__FUNCTION__, "v", {v.rows(), v.cols()},
+             {std::ignore, Nvisible()});
+  std::vector<any> lt;
+  lt.reserve(static_cast<size_t>(v.rows()));
+  for (auto i = Index{0}; i < v.rows(); ++i) {
+    lt.push_back(InitLookup(v.row(i).transpose()));
+  }
+  return any{std::move(lt)};
+}
+
+void AbstractMachine::LogValDiffBatch(
+    Eigen::Ref<const RowMatrix<double>> v,
+    const std::vector<std::vector<int>> &tochange,
+    const std::vector<std::vector<double>> &newconf, const any &lookup,
+    Eigen::Ref<VectorType> out) {
+  CheckShape(__FUNCTION__, "out", out.size(), v.rows());
+  const auto &lt = any_cast_ref<std::vector<any>>(lookup);
+  for (auto i = Index{0}; i < v.rows(); ++i) {
+    const auto k = static_cast<size_t>(i);
+    out(i) = LogValDiff(v.row(i).transpose(), tochange[k], newconf[k], lt[k]);
+  }
+}
+
+void AbstractMachine::UpdateLookupBatch(
+    Eigen::Ref<const RowMatrix<double>> v,
+    const std::vector<std::vector<int>> &tochange,
+    const std::vector<std::vector<double>> &newconf, any &lookup) {
+  auto &lt = any_cast_ref<std::vector<any>>(lookup);
+  for (auto i = Index{0}; i < v.rows(); ++i) {
+    const auto k = static_cast<size_t>(i);
+    if (!tochange[k].empty()) {
+      UpdateLookup(v.row(i).transpose(), tochange[k], newconf[k], lt[k]);
+    }
+  }
+}
+
 Complex AbstractMachine::LogValDiff(VisibleConstType v,
                                     const std::vector<int> &tochange,
                                     const std::vector<double> &newconf,
@@ -184,6 +184,42 @@ class AbstractMachine {
                              const std::vector<int> &tochange,
                              const std::vector<double> &newconf, const any &lt);
 
+  /**
+  Member function initializing the look-up tables for a batch of visible
+  configurations. The default implementation stores the look-up tables of the
+  individual configurations, as returned by InitLookup.
+  @param v a batch of visible configurations, one per row.
+  @return The look-up tables of the whole batch.
+  */
+  virtual any InitLookupBatch(Eigen::Ref<const RowMatrix<double>> v);
+
+  /**
+  Batched version of LogValDiff using look-up tables. Every row of v is a
+  separate configuration with its own change.
+  @param v a batch of visible configurations, one per row.
+  @param tochange for each row of v, the indices of the units to be modified.
+  @param newconf for each row of v, the new values of the units to be modified.
+  @param lt the look-up tables returned by InitLookupBatch.
+  @param out on return, out(i) = log(Psi(v_i')) - log(Psi(v_i)).
+  */
+  virtual void LogValDiffBatch(Eigen::Ref<const RowMatrix<double>> v,
+                               const std::vector<std::vector<int>> &tochange,
+                               const std::vector<std::vector<double>> &newconf,
+                               const any &lt, Eigen::Ref<VectorType> out);
+
+  /**
+  Batched version of UpdateLookup. Rows for which tochange is empty are left
+  untouched.
+  @param v a batch of the current visible configurations, one per row.
+  @param tochange for each row of v, the indices of the units to be modified.
+  @param newconf for each row of v, the new values of the units to be modified.
+  @param lt the look-up tables returned by InitLookupBatch.
+  */
+  virtual void UpdateLookupBatch(
+      Eigen::Ref<const RowMatrix<double>> v,
+      const std::vector<std::vector<int>> &tochange,
+      const std::vector<std::vector<double>> &newconf, any &lt);
+
   /**
   Member function computing the derivative of the logarithm of the wave function
   for a given visible vector.
@@ -46,6 +46,14 @@ class FFNN : public AbstractMachine {
 
   std::unique_ptr<SumOutput> sum_output_layer_;
 
+  // Buffers used by the batched LogVal and DerLog. Samples are stored as
+  // columns, batch_output_[i] contains the outputs of layer i and
+  // batch_din_[i] the derivatives with respect to its inputs.
+  MatrixType batch_input_;
+  std::vector<MatrixType> batch_output_;
+  std::vector<MatrixType> batch_din_;
+  MatrixType batch_der_;
+
  public:
   explicit FFNN(std::shared_ptr<const AbstractHilbert> hilbert,
                 std::vector<AbstractLayer *> layers)
@@ -96,6 +104,9 @@ class FFNN : public AbstractMachine {
     changed_nodes_.resize(nlayer_);
     new_output_.resize(nlayer_);
 
+    batch_output_.resize(nlayer_);
+    batch_din_.resize(depth_);
+
     InfoMessage(buffer) << "# FFNN Initizialized with " << nlayer_
                         << " Layers: ";
     for (int i = 0; i < depth_ - 1; ++i) {
@@ -186,6 +197,46 @@ class FFNN : public AbstractMachine {
     }
   }
 
+  void LogVal(Eigen::Ref<const RowMatrix<double>> v, Eigen::Ref<VectorType> out,
+              const any & /*unused*/) override {
+    CheckShape(__FUNCTION__, "v", {v.rows(), v.cols()},
+               {std::ignore, Nvisible()});
+    CheckShape(__FUNCTION__, "out", out.size(), v.rows());
+    ForwardBatch(v);
+    out = batch_output_.back().row(0).transpose();
+  }
+
+  void DerLog(Eigen::Ref<const RowMatrix<double>> v,
+              Eigen::Ref<RowMatrix<Complex>> out,
+              const any & /*unused*/) override {
+    CheckShape(__FUNCTION__, "v", {v.rows(), v.cols()},
+               {std::ignore, Nvisible()});
+    CheckShape(__FUNCTION__, "out", {out.rows(), out.cols()},
+               {v.rows(), Npar()});
+    ForwardBatch(v);
+
+    batch_din_.back().setOnes(1, v.rows());
+    batch_der_.resize(npar_, v.rows());
+    int start_idx = npar_;
+    for (int i = nlayer_ - 1; i >= 0; --i) {
+      const int num_of_pars = layers_[i]->Npar();
+      start_idx -= num_of_pars;
+      layers_[i]->Backprop(i > 0 ? batch_output_[i - 1] : batch_input_,
+                           batch_output_[i], batch_din_[i + 1], batch_din_[i],
+                           batch_der_.middleRows(start_idx, num_of_pars));
+    }
+    out = batch_der_.transpose();
+  }
+
+  // Feeds the rows of v through the network, filling batch_output_
+  void ForwardBatch(Eigen::Ref<const RowMatrix<double>> v) {
+    batch_input_ = v.transpose().cast<Complex>();
+    layers_[0]->Forward(batch_input_, batch_output_[0]);
+    for (int i = 1; i < nlayer_; ++i) {
+      layers_[i]->Forward(batch_output_[i - 1], batch_output_[i]);
+    }
+  }
+
   Complex LogValSingle(VisibleConstType v, const any &lookup) override {
     assert(nlayer_ > 0);
     if (lookup.empty()) {
@@ -238,16 +289,16 @@ class FFNN : public AbstractMachine {
       const std::vector<std::vector<double>> &newconf) override {
     const int nconn = tochange.size();
     VectorType logvaldiffs = VectorType::Zero(nconn);
-    auto lt = InitLookup(v);
-    auto current_val = LogValSingle(v, lt);
+    // The outputs of all layers are computed once and shared by all the
+    // connectors
+    const auto lookup = InitLookup(v);
+    const auto &lt = any_cast_ref<LookupType>(lookup);
+    const auto current_val = lt.V(nlayer_ - 1)(0);
 
     for (int k = 0; k < nconn; ++k) {
-      logvaldiffs(k) = 0;
       if (tochange[k].size() != 0) {
-        auto ltnew = lt;
-        UpdateLookup(v, tochange[k], newconf[k], ltnew);
-
-        logvaldiffs(k) += LogValSingle(v, ltnew) - current_val;
+        logvaldiffs(k) = LogValChanged(v, tochange[k], newconf[k], lt) -
+                         current_val;
       }
     }
     return logvaldiffs;
@@ -255,17 +306,36 @@ class FFNN : public AbstractMachine {
 
   Complex LogValDiff(VisibleConstType v, const std::vector<int> &tochange,
                      const std::vector<double> &newconf,
-                     const any &lt) override {
+                     const any &lookup) override {
     if (tochange.size() != 0) {
-      auto ltnew = lt;
-      UpdateLookup(v, tochange, newconf, ltnew);
-
-      return LogValSingle(v, ltnew) - LogValSingle(v, lt);
+      const auto &lt = any_cast_ref<LookupType>(lookup);
+      return LogValChanged(v, tochange, newconf, lt) - lt.V(nlayer_ - 1)(0);
     } else {
       return 0.0;
     }
   }
 
+  // Propagates the changes of the visible units through the network and
+  // returns the new log value. Contrary to UpdateLookup the look-up table is
+  // left untouched, so no copy of it is needed.
+  Complex LogValChanged(VisibleConstType v, const std::vector<int> &tochange,
+                        const std::vector<double> &newconf,
+                        const LookupType &lt) {
+    layers_[0]->UpdateLookup(
+        v, tochange,
+        Eigen::Map<const Eigen::VectorXd>(&newconf[0], newconf.size()), lt.V(0),
+        changed_nodes_[0], new_output_[0]);
+    for (int i = 1; i < nlayer_; ++i) {
+      layers_[i]->UpdateLookup(lt.V(i - 1), changed_nodes_[i - 1],
+                               new_output_[i - 1], lt.V(i), changed_nodes_[i],
+                               new_output_[i]);
+    }
+    if (changed_nodes_[nlayer_ - 1].empty()) {
+      return lt.V(nlayer_ - 1)(0);
+    }
+    return new_output_[nlayer_ - 1](0);
+  }
+
   void Save(std::string const &filename) const override {
     json state;
     state["Name"] = "FFNN";
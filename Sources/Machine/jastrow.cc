@@ -16,6 +16,7 @@
 
 #include "Machine/jastrow.hpp"
 
+#include "Utils/exceptions.hpp"
 #include "Utils/json_utils.hpp"
 #include "Utils/messages.hpp"
 
@@ -38,7 +39,6 @@ void Jastrow::Init() {
   npar_ = (nv_ * (nv_ - 1)) / 2;
 
   thetas_.resize(nv_);
-  thetasnew_.resize(nv_);
 
   InfoMessage() << "Jastrow WF Initizialized with nvisible = " << nv_
                 << " and nparams = " << npar_ << std::endl;
@@ -96,7 +96,33 @@ void Jastrow::UpdateLookup(VisibleConstType v, const std::vector<int> &tochange,
   if (tochange.size() != 0) {
     for (std::size_t s = 0; s < tochange.size(); s++) {
       const int sf = tochange[s];
-      lt.V(0) += W_.row(sf) * (newconf[s] - v(sf));
+      lt.V(0) += W_.col(sf) * (newconf[s] - v(sf));
+    }
+  }
+}
+
+void Jastrow::LogVal(Eigen::Ref<const RowMatrix<double>> x,
+                     Eigen::Ref<VectorType> out, const any & /*unused*/) {
+  CheckShape(__FUNCTION__, "v", {x.rows(), x.cols()},
+             {std::ignore, Nvisible()});
+  CheckShape(__FUNCTION__, "out", out.size(), x.rows());
+  // log(psi) = 0.5 * x^T W x is evaluated for the whole batch with one GEMM
+  xw_.noalias() = x.cast<Complex>() * W_;
+  out = 0.5 * (xw_.array() * x.cast<Complex>().array()).rowwise().sum();
+}
+
+void Jastrow::DerLog(Eigen::Ref<const RowMatrix<double>> x,
+                     Eigen::Ref<RowMatrix<Complex>> out,
+                     const any & /*unused*/) {
+  CheckShape(__FUNCTION__, "v", {x.rows(), x.cols()},
+             {std::ignore, Nvisible()});
+  CheckShape(__FUNCTION__, "out", {out.rows(), out.cols()}, {x.rows(), Npar()});
+  for (Index b = 0; b < x.rows(); ++b) {
+    int k = 0;
+    for (int i = 0; i < nv_ - 1; i++) {
+      out.row(b).segment(k, nv_ - i - 1) =
+          (x(b, i) * x.row(b).tail(nv_ - i - 1)).cast<Complex>();
+      k += nv_ - i - 1;
     }
   }
 }
@@ -108,6 +134,26 @@ Complex Jastrow::LogValSingle(VisibleConstType v, const any &lt) {
   return 0.5 * v.dot(any_cast_ref<LookupType>(lt).V(0));
 }
 
+// With delta = v' - v, log(psi(v')) - log(psi(v)) = delta^T W v +
+// 0.5 * delta^T W delta, where only the entries of delta on the changed sites
+// are non-zero
+Complex Jastrow::LogValDiffImpl(VisibleConstType v,
+                                const std::vector<int> &tochange,
+                                const std::vector<double> &newconf,
+                                const VectorType &thetas) const {
+  Complex logvaldiff = 0.;
+  for (std::size_t s = 0; s < tochange.size(); s++) {
+    const int sf = tochange[s];
+    const double delta = newconf[s] - v(sf);
+    logvaldiff += delta * thetas(sf);
+    for (std::size_t t = 0; t < s; t++) {
+      const int tf = tochange[t];
+      logvaldiff += delta * W_(sf, tf) * (newconf[t] - v(tf));
+    }
+  }
+  return logvaldiff;
+}
+
 // Difference between logarithms of values, when one or more visible variables
 // are being flipped
 Jastrow::VectorType Jastrow::LogValDiff(
@@ -116,23 +162,10 @@ Jastrow::VectorType Jastrow::LogValDiff(
   const std::size_t nconn = tochange.size();
   VectorType logvaldiffs = VectorType::Zero(nconn);
 
-  thetas_ = (W_.transpose() * v);
-  Complex logtsum = 0.5 * v.dot(thetas_);
+  thetas_.noalias() = W_ * v;
 
   for (std::size_t k = 0; k < nconn; k++) {
-    if (tochange[k].size() != 0) {
-      thetasnew_ = thetas_;
-      Eigen::VectorXd vnew(v);
-
-      for (std::size_t s = 0; s < tochange[k].size(); s++) {
-        const int sf = tochange[k][s];
-
-        thetasnew_ += W_.row(sf) * (newconf[k][s] - v(sf));
-        vnew(sf) = newconf[k][s];
-      }
-
-      logvaldiffs(k) = 0.5 * vnew.dot(thetasnew_) - logtsum;
-    }
+    logvaldiffs(k) = LogValDiffImpl(v, tochange[k], newconf[k], thetas_);
   }
   return logvaldiffs;
 }
@@ -141,25 +174,11 @@ Complex Jastrow::LogValDiff(VisibleConstType v,
                             const std::vector<int> &tochange,
                             const std::vector<double> &newconf,
                             const any &lookup) {
-  Complex logvaldiff = 0.;
-
   if (tochange.size() != 0) {
     const auto &lt = any_cast_ref<LookupType>(lookup);
-    Complex logtsum = 0.5 * v.dot(lt.V(0));
-    thetasnew_ = lt.V(0);
-    Eigen::VectorXd vnew(v);
-
-    for (std::size_t s = 0; s < tochange.size(); s++) {
-      const int sf = tochange[s];
-
-      thetasnew_ += W_.row(sf) * (newconf[s] - v(sf));
-      vnew(sf) = newconf[s];
-    }
-
-    logvaldiff = 0.5 * vnew.dot(thetasnew_) - logtsum;
+    return LogValDiffImpl(v, tochange, newconf, lt.V(0));
   }
-
-  return logvaldiff;
+  return 0.;
 }
 
 Jastrow::VectorType Jastrow::DerLogSingle(VisibleConstType v,
@@ -36,9 +36,15 @@ class Jastrow : public AbstractMachine {
 
   // buffers
   VectorType thetas_;
-  VectorType thetasnew_;
+  RowMatrix<Complex> xw_;
 
   inline void Init();
+  // Change of the log value when the visible units in tochange are set to
+  // newconf, given thetas = W * v. Costs O(tochange.size()^2).
+  inline Complex LogValDiffImpl(VisibleConstType v,
+                                const std::vector<int> &tochange,
+                                const std::vector<double> &newconf,
+                                const VectorType &thetas) const;
 
  public:
   explicit Jastrow(std::shared_ptr<const AbstractHilbert> hilbert);
@@ -51,6 +57,10 @@ class Jastrow : public AbstractMachine {
   any InitLookup(VisibleConstType v) override;
   void UpdateLookup(VisibleConstType v, const std::vector<int> &tochange,
                     const std::vector<double> &newconf, any &lt) override;
+  void LogVal(Eigen::Ref<const RowMatrix<double>> v, Eigen::Ref<VectorType> out,
+              const any &lt) override;
+  void DerLog(Eigen::Ref<const RowMatrix<double>> v,
+              Eigen::Ref<RowMatrix<Complex>> out, const any &lt) override;
   Complex LogValSingle(VisibleConstType v, const any &lt) override;
 
   VectorType LogValDiff(
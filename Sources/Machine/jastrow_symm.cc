@@ -17,6 +17,7 @@
 
 #include "Machine/jastrow_symm.hpp"
 
+#include "Utils/exceptions.hpp"
 #include "Utils/json_utils.hpp"
 #include "Utils/messages.hpp"
 
@@ -46,20 +47,19 @@ void JastrowSymm::Init(const AbstractGraph &graph) {
   W_.resize(nv_, nv_);
   W_.setZero();
   thetas_.resize(nv_);
-  thetasnew_.resize(nv_);
 
   nbarepar_ = (nv_ * (nv_ - 1)) / 2;
 
-  // Constructing the matrix that maps the bare derivatives to the symmetric
-  // ones
-
-  Wtemp_ = Eigen::MatrixXi::Zero(nv_, nv_);
-
-  std::map<int, int> params;
-  int k = 0;
-
+  // Orbits of the pairs of sites under the symmetry group, numbered in order
+  // of first appearance. Each orbit is visited only once, so this costs
+  // O(nv^2 + npar * permsize) instead of O(nv^2 * permsize).
+  pair_orbit_ = Eigen::MatrixXi::Constant(nv_, nv_, -1);
+  npar_ = 0;
   for (int i = 0; i < nv_; i++) {
     for (int j = i + 1; j < nv_; j++) {
+      if (pair_orbit_(i, j) >= 0) {
+        continue;
+      }
       for (int l = 0; l < permsize_; l++) {
         int isymm = permtable_[l][i];
         int jsymm = permtable_[l][j];
@@ -68,55 +68,15 @@ void JastrowSymm::Init(const AbstractGraph &graph) {
           std::cerr << "Error in JastrowSymm" << std::endl;
           std::abort();
         }
-        Wtemp_(isymm, jsymm) = k;
-        Wtemp_(jsymm, isymm) = k;
+        pair_orbit_(isymm, jsymm) = npar_;
+        pair_orbit_(jsymm, isymm) = npar_;
       }  // l
-      k++;
+      npar_++;
     }  // j
   }    // i
 
-  int nk_unique = 0;
-
-  for (int i = 0; i < nv_; i++) {
-    for (int j = i + 1; j < nv_; j++) {
-      k = Wtemp_(i, j);
-      if (params.count(k) == 0) {
-        nk_unique++;
-        params.insert(std::pair<int, int>(k, nk_unique));
-      }
-    }
-  }
-
-  npar_ = params.size();
-
-  for (int i = 0; i < nv_; i++) {
-    for (int j = i + 1; j < nv_; j++) {
-      if (params.count(Wtemp_(i, j))) {
-        Wtemp_(i, j) = params.find(Wtemp_(i, j))->second;
-      } else {
-        std::cerr << "Error in JastrowSymm" << std::endl;
-        std::abort();
-      }
-      Wtemp_(j, i) = Wtemp_(i, j);
-    }
-  }
-
-  DerMatSymm_ = Eigen::MatrixXd::Zero(npar_, nbarepar_);
   Wsymm_.resize(npar_, 1);  // used to stay close to RbmSpinSymm class
 
-  int kbare = 0;
-  for (int i = 0; i < nv_; i++) {
-    for (int j = i + 1; j < nv_; j++) {
-      int ksymm = Wtemp_(i, j);
-      if (ksymm < 1 || ksymm - 1 >= npar_) {
-        std::cerr << "Error in JastrowSymm" << std::endl;
-        std::abort();
-      }
-      DerMatSymm_(ksymm - 1, kbare) = 1;
-      kbare++;
-    }
-  }
-
   InfoMessage() << "Jastrow WF Initizialized with nvisible = " << nv_
                 << std::endl;
   InfoMessage() << "Symmetries are being used : " << npar_
@@ -143,29 +103,36 @@ void JastrowSymm::UpdateLookup(VisibleConstType v,
   if (tochange.size() != 0) {
     for (std::size_t s = 0; s < tochange.size(); s++) {
       const int sf = tochange[s];
-      lt.V(0) += W_.row(sf) * (newconf[s] - v(sf));
+      lt.V(0) += W_.col(sf) * (newconf[s] - v(sf));
     }
   }
 }
 
-JastrowSymm::VectorType JastrowSymm::BareDerLog(VisibleConstType v) {
-  VectorType der(nbarepar_);
-
-  int k = 0;
+JastrowSymm::VectorType JastrowSymm::DerLogSingle(VisibleConstType v,
+                                                  const any & /*unused*/) {
+  VectorType der = VectorType::Zero(npar_);
   for (int i = 0; i < nv_; i++) {
     for (int j = i + 1; j < nv_; j++) {
-      der(k) = v(i) * v(j);
-      k++;
+      der(pair_orbit_(i, j)) += v(i) * v(j);
     }
   }
-
   return der;
 }
 
-// now unchanged w.r.t. RBM spin symm
-JastrowSymm::VectorType JastrowSymm::DerLogSingle(VisibleConstType v,
-                                                  const any & /*unused*/) {
-  return DerMatSymm_ * BareDerLog(v);
+void JastrowSymm::DerLog(Eigen::Ref<const RowMatrix<double>> x,
+                         Eigen::Ref<RowMatrix<Complex>> out,
+                         const any & /*unused*/) {
+  CheckShape(__FUNCTION__, "v", {x.rows(), x.cols()},
+             {std::ignore, Nvisible()});
+  CheckShape(__FUNCTION__, "out", {out.rows(), out.cols()}, {x.rows(), Npar()});
+  out.setZero();
+  for (Index b = 0; b < x.rows(); ++b) {
+    for (int i = 0; i < nv_; i++) {
+      for (int j = i + 1; j < nv_; j++) {
+        out(b, pair_orbit_(i, j)) += x(b, i) * x(b, j);
+      }
+    }
+  }
 }
 
 JastrowSymm::VectorType JastrowSymm::GetParameters() {
@@ -193,14 +160,24 @@ void JastrowSymm::SetParameters(VectorConstRefType pars) {
 
 void JastrowSymm::SetBareParameters() {
   for (int i = 0; i < nv_; i++) {
+    W_(i, i) = Complex(0);
     for (int j = i + 1; j < nv_; j++) {
-      W_(i, j) = Wsymm_(Wtemp_(i, j) - 1, 0);
+      W_(i, j) = Wsymm_(pair_orbit_(i, j), 0);
       W_(j, i) = W_(i, j);  // create the lover triangle
-      W_(i, i) = Complex(0);
     }
   }
 }
 
+void JastrowSymm::LogVal(Eigen::Ref<const RowMatrix<double>> x,
+                         Eigen::Ref<VectorType> out, const any & /*unused*/) {
+  CheckShape(__FUNCTION__, "v", {x.rows(), x.cols()},
+             {std::ignore, Nvisible()});
+  CheckShape(__FUNCTION__, "out", out.size(), x.rows());
+  // log(psi) = 0.5 * x^T W x is evaluated for the whole batch with one GEMM
+  xw_.noalias() = x.cast<Complex>() * W_;
+  out = 0.5 * (xw_.array() * x.cast<Complex>().array()).rowwise().sum();
+}
+
 // Value of the logarithm of the wave-function
 // using pre-computed look-up tables for efficiency
 Complex JastrowSymm::LogValSingle(VisibleConstType v, const any &lt) {
@@ -208,6 +185,24 @@ Complex JastrowSymm::LogValSingle(VisibleConstType v, const any &lt) {
   return 0.5 * v.dot(any_cast_ref<LookupType>(lt).V(0));
 }
 
+// same as for Jastrow
+Complex JastrowSymm::LogValDiffImpl(VisibleConstType v,
+                                    const std::vector<int> &tochange,
+                                    const std::vector<double> &newconf,
+                                    const VectorType &thetas) const {
+  Complex logvaldiff = 0.;
+  for (std::size_t s = 0; s < tochange.size(); s++) {
+    const int sf = tochange[s];
+    const double delta = newconf[s] - v(sf);
+    logvaldiff += delta * thetas(sf);
+    for (std::size_t t = 0; t < s; t++) {
+      const int tf = tochange[t];
+      logvaldiff += delta * W_(sf, tf) * (newconf[t] - v(tf));
+    }
+  }
+  return logvaldiff;
+}
+
 // Difference between logarithms of values, when one or more visible
 // variables are being flipped
 JastrowSymm::VectorType JastrowSymm::LogValDiff(
@@ -216,23 +211,10 @@ JastrowSymm::VectorType JastrowSymm::LogValDiff(
   const std::size_t nconn = tochange.size();
   VectorType logvaldiffs = VectorType::Zero(nconn);
 
-  thetas_ = (W_.transpose() * v);
-  Complex logtsum = 0.5 * v.dot(thetas_);
+  thetas_.noalias() = W_ * v;
 
   for (std::size_t k = 0; k < nconn; k++) {
-    if (tochange[k].size() != 0) {
-      thetasnew_ = thetas_;
-      Eigen::VectorXd vnew(v);
-
-      for (std::size_t s = 0; s < tochange[k].size(); s++) {
-        const int sf = tochange[k][s];
-
-        thetasnew_ += W_.row(sf) * (newconf[k][s] - v(sf));
-        vnew(sf) = newconf[k][s];
-      }
-
-      logvaldiffs(k) = 0.5 * vnew.dot(thetasnew_) - logtsum;
-    }
+    logvaldiffs(k) = LogValDiffImpl(v, tochange[k], newconf[k], thetas_);
   }
 
   return logvaldiffs;
@@ -242,25 +224,11 @@ Complex JastrowSymm::LogValDiff(VisibleConstType v,
                                 const std::vector<int> &tochange,
                                 const std::vector<double> &newconf,
                                 const any &lookup) {
-  Complex logvaldiff = 0.;
-
   if (tochange.size() != 0) {
     const auto &lt = any_cast_ref<LookupType>(lookup);
-    Complex logtsum = 0.5 * v.dot(lt.V(0));
-    thetasnew_ = lt.V(0);
-    Eigen::VectorXd vnew(v);
-
-    for (std::size_t s = 0; s < tochange.size(); s++) {
-      const int sf = tochange[s];
-
-      thetasnew_ += W_.row(sf) * (newconf[s] - v(sf));
-      vnew(sf) = newconf[s];
-    }
-
-    logvaldiff = 0.5 * vnew.dot(thetasnew_) - logtsum;
+    return LogValDiffImpl(v, tochange, newconf, lt.V(0));
   }
-
-  return logvaldiff;
+  return 0.;
 }
 
 bool JastrowSymm::IsHolomorphic() const noexcept { return true; }
@@ -38,17 +38,18 @@ class JastrowSymm : public AbstractMachine {
   // number of parameters without symmetries
   int nbarepar_;
 
-  // weights
+  // weights, gathered from Wsymm_
   MatrixType W_;
 
-  // weights with symmetries
+  // weights with symmetries, one per orbit of pairs of sites
   MatrixType Wsymm_;
 
-  VectorType thetas_;
-  VectorType thetasnew_;
+  // pair_orbit_(i, j) is the index of the orbit of the pair (i, j) under the
+  // symmetry group, i.e. of its parameter in Wsymm_
+  Eigen::MatrixXi pair_orbit_;
 
-  Eigen::MatrixXd DerMatSymm_;
-  Eigen::MatrixXi Wtemp_;
+  VectorType thetas_;
+  RowMatrix<Complex> xw_;
 
  public:
   explicit JastrowSymm(std::shared_ptr<const AbstractHilbert> hilbert);
@@ -65,6 +66,10 @@ class JastrowSymm : public AbstractMachine {
   VectorType GetParameters() override;
   void SetParameters(VectorConstRefType pars) override;
 
+  void LogVal(Eigen::Ref<const RowMatrix<double>> v, Eigen::Ref<VectorType> out,
+              const any &lt) override;
+  void DerLog(Eigen::Ref<const RowMatrix<double>> v,
+              Eigen::Ref<RowMatrix<Complex>> out, const any &lt) override;
   Complex LogValSingle(VisibleConstType v, const any &lt) override;
   VectorType LogValDiff(
       VisibleConstType v, const std::vector<std::vector<int>> &tochange,
@@ -81,8 +86,13 @@ class JastrowSymm : public AbstractMachine {
  private:
   inline void Init(const AbstractGraph &graph);
 
-  VectorType BareDerLog(VisibleConstType v);
   void SetBareParameters();
+  // Change of the log value when the visible units in tochange are set to
+  // newconf, given thetas = W * v. Costs O(tochange.size()^2).
+  inline Complex LogValDiffImpl(VisibleConstType v,
+                                const std::vector<int> &tochange,
+                                const std::vector<double> &newconf,
+                                const VectorType &thetas) const;
 };
 
 }  // namespace netket
@@ -25,6 +25,7 @@
 #include "jastrow.hpp"
 #include "jastrow_symm.hpp"
 #include "mps_periodic.hpp"
+#include "product_machine.hpp"
 #include "rbm_multival.hpp"
 #include "rbm_spin.hpp"
 #include "rbm_spin_phase.hpp"
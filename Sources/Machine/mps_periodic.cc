@@ -18,6 +18,7 @@
 
 #include <set>
 
+#include "Utils/exceptions.hpp"
 #include "Utils/json_utils.hpp"
 #include "Utils/messages.hpp"
 
@@ -52,6 +53,14 @@ Complex MPSPeriodic::trace(const MatrixType &m) const {
   return m.trace();
 }
 
+Complex MPSPeriodic::trace_prod(const MatrixType &m1,
+                                const MatrixType &m2) const {
+  if (is_diag_) {
+    return m1.cwiseProduct(m2).sum();
+  }
+  return m1.transpose().cwiseProduct(m2).sum();
+}
+
 void MPSPeriodic::setparamsident(MatrixType &m, VectorConstRefType pars) const {
   if (is_diag_) {
     for (int i = 0; i < D_; i++) {
@@ -348,11 +357,60 @@ MPSPeriodic::MatrixType MPSPeriodic::mps_contraction(VisibleConstType v,
   return c;
 }
 
+void MPSPeriodic::LogVal(Eigen::Ref<const RowMatrix<double>> v,
+                         Eigen::Ref<VectorType> out, const any & /*unused*/) {
+  CheckShape(__FUNCTION__, "v", {v.rows(), v.cols()},
+             {std::ignore, Nvisible()});
+  CheckShape(__FUNCTION__, "out", out.size(), v.rows());
+  const auto batch = v.rows();
+
+  // Resolve the MPS indices of the local states once for the whole batch
+  states_.resize(batch, N_);
+  for (Index b = 0; b < batch; ++b) {
+    for (int site = 0; site < N_; site++) {
+      states_(b, site) = confindex_[v(b, site)];
+    }
+  }
+
+  // A GEMM over the stacked D x D partial products of all the samples turns
+  // out to be slower than the individual products for the bond dimensions
+  // used in practice, so the samples are contracted independently instead.
+#pragma omp parallel for schedule(static)
+  for (Index b = 0; b < batch; ++b) {
+    MatrixType c = W_[0][states_(b, 0)];
+    MatrixType tmp(D_, Dsec_);
+    for (int site = 1; site < N_; site++) {
+      const auto &W = W_[site % symperiod_][states_(b, site)];
+      if (is_diag_) {
+        c.array() *= W.array();
+      } else {
+        tmp.noalias() = c * W;
+        c.swap(tmp);
+      }
+    }
+    out(b) = std::log(trace(c));
+  }
+}
+
 Complex MPSPeriodic::LogValSingle(VisibleConstType v, const any &lt) {
   if (lt.empty()) return std::log(trace(mps_contraction(v, 0, N_)));
   return std::log(trace(any_cast_ref<LookupType>(lt).M(Nleaves_ - 1)));
 }
 
+void MPSPeriodic::ComputeEnvironments(VisibleConstType v) {
+  left_prods_.resize(N_);
+  right_prods_.resize(N_);
+  left_prods_[0] = W_[0][confindex_[v(0)]];
+  right_prods_[N_ - 1] = W_[(N_ - 1) % symperiod_][confindex_[v(N_ - 1)]];
+  for (int site = 1; site < N_; site++) {
+    left_prods_[site] = prod(left_prods_[site - 1],
+                             W_[site % symperiod_][confindex_[v(site)]]);
+    const int rsite = N_ - 1 - site;
+    right_prods_[rsite] = prod(W_[rsite % symperiod_][confindex_[v(rsite)]],
+                               right_prods_[rsite + 1]);
+  }
+}
+
 MPSPeriodic::VectorType MPSPeriodic::LogValDiff(
     VisibleConstType v, const std::vector<std::vector<int>> &tochange,
     const std::vector<std::vector<double>> &newconf) {
@@ -360,7 +418,11 @@ MPSPeriodic::VectorType MPSPeriodic::LogValDiff(
 
   std::vector<std::size_t> sorted_ind;
   VectorType logvaldiffs = VectorType::Zero(nconn);
-  Complex current_psi = trace(mps_contraction(v, 0, N_));
+  // The environments are shared by all the connectors, so that only the
+  // matrices between the first and the last changed site have to be
+  // contracted for each of them
+  ComputeEnvironments(v);
+  const Complex current_psi = trace(left_prods_[N_ - 1]);
   MatrixType new_prods(D_, Dsec_);
 
   for (std::size_t k = 0; k < nconn; k++) {
@@ -369,26 +431,31 @@ MPSPeriodic::VectorType MPSPeriodic::LogValDiff(
       sorted_ind = sort_indeces(tochange[k]);
       int site = tochange[k][sorted_ind[0]];
 
+      const MatrixType &first =
+          W_[site % symperiod_][confindex_[newconf[k][sorted_ind[0]]]];
       if (site == 0) {
-        new_prods = W_[0][confindex_[newconf[k][sorted_ind[0]]]];
+        new_prods = first;
       } else {
-        new_prods =
-            prod(mps_contraction(v, 0, site),
-                 W_[site % symperiod_][confindex_[newconf[k][sorted_ind[0]]]]);
+        new_prods = prod(left_prods_[site - 1], first);
       }
 
       for (std::size_t i = 1; i < nchange; i++) {
+        for (int s = tochange[k][sorted_ind[i - 1]] + 1;
+             s < tochange[k][sorted_ind[i]]; s++) {
+          new_prods = prod(new_prods, W_[s % symperiod_][confindex_[v(s)]]);
+        }
         site = tochange[k][sorted_ind[i]];
         new_prods = prod(
             new_prods,
-            prod(mps_contraction(v, tochange[k][sorted_ind[i - 1]] + 1, site),
-                 W_[site % symperiod_][confindex_[newconf[k][sorted_ind[i]]]]));
+            W_[site % symperiod_][confindex_[newconf[k][sorted_ind[i]]]]);
       }
-      site = tochange[k][sorted_ind[nchange - 1]];
+      Complex new_psi;
       if (site < N_ - 1) {
-        new_prods = prod(new_prods, mps_contraction(v, site + 1, N_));
+        new_psi = trace_prod(new_prods, right_prods_[site + 1]);
+      } else {
+        new_psi = trace(new_prods);
       }
-      logvaldiffs(k) = std::log(trace(new_prods) / current_psi);
+      logvaldiffs(k) = std::log(new_psi / current_psi);
     }
   }
   return logvaldiffs;
@@ -464,40 +531,28 @@ Complex MPSPeriodic::LogValDiff(VisibleConstType v,
   return std::log(trace(ltpM[Nleaves_ + N_ - 1]) / trace(lt.M(Nleaves_ - 1)));
 }
 
-// Derivative with full calculation
+// Derivative with full calculation, using the left and right environments
 MPSPeriodic::VectorType MPSPeriodic::DerLogSingle(VisibleConstType v,
                                                   const any & /*unused*/) {
   MatrixType temp_product(D_, Dsec_);
-  std::vector<MatrixType> left_prods, right_prods;
   VectorType der = VectorType::Zero(npar_);
 
-  // Calculate products
-  left_prods.push_back(W_[0][confindex_[v(0)]]);
-  right_prods.push_back(W_[(N_ - 1) % symperiod_][confindex_[v(N_ - 1)]]);
-  for (int site = 1; site < N_ - 1; site++) {
-    left_prods.push_back(
-        prod(left_prods[site - 1], W_[site % symperiod_][confindex_[v(site)]]));
-    right_prods.push_back(
-        prod(W_[(N_ - 1 - site) % symperiod_][confindex_[v(N_ - 1 - site)]],
-             right_prods[site - 1]));
-  }
-  left_prods.push_back(prod(left_prods[N_ - 2],
-                            W_[(N_ - 1) % symperiod_][confindex_[v(N_ - 1)]]));
-  right_prods.push_back(prod(W_[0][confindex_[v(0)]], right_prods[N_ - 2]));
-
-  der.segment(confindex_[v(0)] * Dsq_, Dsq_) +=
-      Eigen::Map<VectorType>(right_prods[N_ - 2].transpose().data(), Dsq_);
-  for (int site = 1; site < N_ - 1; site++) {
-    temp_product = prod(right_prods[N_ - site - 2], left_prods[site - 1]);
+  ComputeEnvironments(v);
+
+  // d trace(L W R) / dW(i, j) = (R L)(j, i)
+  for (int site = 0; site < N_; site++) {
+    if (site == 0) {
+      temp_product = N_ > 1 ? right_prods_[1] : identity_mat_;
+    } else if (site == N_ - 1) {
+      temp_product = left_prods_[N_ - 2];
+    } else {
+      temp_product = prod(right_prods_[site + 1], left_prods_[site - 1]);
+    }
     der.segment((d_ * (site % symperiod_) + confindex_[v(site)]) * Dsq_,
-                Dsq_) +=
-        Eigen::Map<VectorType>(temp_product.transpose().data(), Dsq_);
+                Dsq_) += Eigen::Map<VectorType>(temp_product.data(), Dsq_);
   }
-  der.segment((d_ * ((N_ - 1) % symperiod_) + confindex_[v(N_ - 1)]) * Dsq_,
-              Dsq_) +=
-      Eigen::Map<VectorType>(left_prods[N_ - 2].transpose().data(), Dsq_);
 
-  return der / trace(left_prods[N_ - 1]);
+  return der / trace(left_prods_[N_ - 1]);
 }
 
 // Json functions
@@ -58,6 +58,15 @@ class MPSPeriodic : public AbstractMachine {
   // Identity Matrix
   MatrixType identity_mat_;
 
+  // Left and right environments of the last configuration passed to
+  // ComputeEnvironments: left_prods_[i] = W(0) ... W(i) and
+  // right_prods_[i] = W(i) ... W(N - 1)
+  std::vector<MatrixType> left_prods_;
+  std::vector<MatrixType> right_prods_;
+
+  // MPS indices of the local states of the batch passed to LogVal
+  RowMatrix<int> states_;
+
  public:
   MPSPeriodic(std::shared_ptr<const AbstractHilbert> hilbert, int bond_dim,
               bool diag, int symperiod = -1);
@@ -71,6 +80,8 @@ class MPSPeriodic : public AbstractMachine {
   void UpdateLookup(VisibleConstType v, const std::vector<int> &tochange,
                     const std::vector<double> &newconf, any &lt) override;
 
+  void LogVal(Eigen::Ref<const RowMatrix<double>> v, Eigen::Ref<VectorType> out,
+              const any &lt) override;
   Complex LogValSingle(VisibleConstType v, const any &lt) override;
   VectorType LogValDiff(
       VisibleConstType v, const std::vector<std::vector<int>> &tochange,
@@ -88,6 +99,8 @@ class MPSPeriodic : public AbstractMachine {
  private:
   inline MatrixType prod(const MatrixType &m1, const MatrixType &m2) const;
   inline Complex trace(const MatrixType &m) const;
+  // Computes trace(prod(m1, m2)) without forming the product
+  inline Complex trace_prod(const MatrixType &m1, const MatrixType &m2) const;
   inline void setparamsident(MatrixType &m, VectorConstRefType pars) const;
   inline void Init();
   inline void InitTree();
@@ -102,6 +115,8 @@ class MPSPeriodic : public AbstractMachine {
   // Auxiliary function that calculates contractions from site1 to site2
   inline MatrixType mps_contraction(VisibleConstType v, const int &site1,
                                     const int &site2);
+  // Fills left_prods_ and right_prods_ for the configuration v
+  inline void ComputeEnvironments(VisibleConstType v);
 };
 
 }  // namespace netket
@@ -0,0 +1,210 @@
+// Copyright 2018 The Simons Foundation, Inc. - All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "Machine/product_machine.hpp"
+
+#include "Utils/exceptions.hpp"
+#include "Utils/json_utils.hpp"
+#include "Utils/messages.hpp"
+
+namespace netket {
+
+ProductMachine::ProductMachine(std::shared_ptr<const AbstractHilbert> hilbert,
+                               std::vector<AbstractMachine *> machines)
+    : AbstractMachine(hilbert), machines_(std::move(machines)), npar_(0) {
+  if (machines_.empty()) {
+    throw InvalidInputError(
+        "Cannot construct a ProductMachine without any machine");
+  }
+  for (auto const machine : machines_) {
+    if (machine->Nvisible() != hilbert->Size()) {
+      throw InvalidInputError(
+          "Number of visible units of a factor is incompatible with given "
+          "Hilbert space");
+    }
+    npars_.push_back(machine->Npar());
+    npar_ += npars_.back();
+  }
+
+  InfoMessage() << "Product machine with " << machines_.size()
+                << " factors and " << npar_ << " parameters created"
+                << std::endl;
+}
+
+int ProductMachine::Nvisible() const { return GetHilbert().Size(); }
+
+int ProductMachine::Npar() const { return npar_; }
+
+ProductMachine::VectorType ProductMachine::GetParameters() {
+  VectorType pars(npar_);
+  int start_idx = 0;
+  for (std::size_t i = 0; i < machines_.size(); ++i) {
+    pars.segment(start_idx, npars_[i]) = machines_[i]->GetParameters();
+    start_idx += npars_[i];
+  }
+  return pars;
+}
+
+void ProductMachine::SetParameters(VectorConstRefType pars) {
+  int start_idx = 0;
+  for (std::size_t i = 0; i < machines_.size(); ++i) {
+    machines_[i]->SetParameters(pars.segment(start_idx, npars_[i]));
+    start_idx += npars_[i];
+  }
+}
+
+void ProductMachine::LogVal(Eigen::Ref<const RowMatrix<double>> v,
+                            Eigen::Ref<VectorType> out,
+                            const any & /*unused*/) {
+  CheckShape(__FUNCTION__, "v", {v.rows(), v.cols()},
+             {std::ignore, Nvisible()});
+  CheckShape(__FUNCTION__, "out", out.size(), v.rows());
+  machines_[0]->LogVal(v, out, any{});
+  logvals_.resize(v.rows());
+  for (std::size_t i = 1; i < machines_.size(); ++i) {
+    machines_[i]->LogVal(v, logvals_, any{});
+    out += logvals_;
+  }
+}
+
+void ProductMachine::DerLog(Eigen::Ref<const RowMatrix<double>> v,
+                            Eigen::Ref<RowMatrix<Complex>> out,
+                            const any & /*unused*/) {
+  CheckShape(__FUNCTION__, "v", {v.rows(), v.cols()},
+             {std::ignore, Nvisible()});
+  CheckShape(__FUNCTION__, "out", {out.rows(), out.cols()}, {v.rows(), Npar()});
+  int start_idx = 0;
+  for (std::size_t i = 0; i < machines_.size(); ++i) {
+    machines_[i]->DerLog(v, out.middleCols(start_idx, npars_[i]), any{});
+    start_idx += npars_[i];
+  }
+}
+
+// The look-up table of the product is the list of the look-up tables of the
+// factors
+any ProductMachine::InitLookup(VisibleConstType v) {
+  std::vector<any> lt;
+  lt.reserve(machines_.size());
+  for (auto const machine : machines_) {
+    lt.push_back(machine->InitLookup(v));
+  }
+  return any{std::move(lt)};
+}
+
+void ProductMachine::UpdateLookup(VisibleConstType v,
+                                  const std::vector<int> &tochange,
+                                  const std::vector<double> &newconf,
+                                  any &lookup) {
+  auto &lt = any_cast_ref<std::vector<any>>(lookup);
+  for (std::size_t i = 0; i < machines_.size(); ++i) {
+    machines_[i]->UpdateLookup(v, tochange, newconf, lt[i]);
+  }
+}
+
+Complex ProductMachine::LogValSingle(VisibleConstType v, const any &lookup) {
+  Complex logval = 0.;
+  if (lookup.empty()) {
+    for (auto const machine : machines_) {
+      logval += machine->LogValSingle(v, any{});
+    }
+  } else {
+    const auto &lt = any_cast_ref<std::vector<any>>(lookup);
+    for (std::size_t i = 0; i < machines_.size(); ++i) {
+      logval += machines_[i]->LogValSingle(v, lt[i]);
+    }
+  }
+  return logval;
+}
+
+ProductMachine::VectorType ProductMachine::LogValDiff(
+    VisibleConstType v, const std::vector<std::vector<int>> &tochange,
+    const std::vector<std::vector<double>> &newconf) {
+  VectorType logvaldiffs = machines_[0]->LogValDiff(v, tochange, newconf);
+  for (std::size_t i = 1; i < machines_.size(); ++i) {
+    logvaldiffs += machines_[i]->LogValDiff(v, tochange, newconf);
+  }
+  return logvaldiffs;
+}
+
+Complex ProductMachine::LogValDiff(VisibleConstType v,
+                                   const std::vector<int> &tochange,
+                                   const std::vector<double> &newconf,
+                                   const any &lookup) {
+  const auto &lt = any_cast_ref<std::vector<any>>(lookup);
+  Complex logvaldiff = 0.;
+  for (std::size_t i = 0; i < machines_.size(); ++i) {
+    logvaldiff += machines_[i]->LogValDiff(v, tochange, newconf, lt[i]);
+  }
+  return logvaldiff;
+}
+
+ProductMachine::VectorType ProductMachine::DerLogSingle(VisibleConstType v,
+                                                        const any &lookup) {
+  VectorType der(npar_);
+  int start_idx = 0;
+  for (std::size_t i = 0; i < machines_.size(); ++i) {
+    if (lookup.empty()) {
+      der.segment(start_idx, npars_[i]) = machines_[i]->DerLogSingle(v, any{});
+    } else {
+      const auto &lt = any_cast_ref<std::vector<any>>(lookup);
+      der.segment(start_idx, npars_[i]) = machines_[i]->DerLogSingle(v, lt[i]);
+    }
+    start_idx += npars_[i];
+  }
+  return der;
+}
+
+void ProductMachine::Save(const std::string &filename) const {
+  json state;
+  state["Name"] = "ProductMachine";
+  state["Nfactors"] = machines_.size();
+  VectorType pars(npar_);
+  int start_idx = 0;
+  for (std::size_t i = 0; i < machines_.size(); ++i) {
+    pars.segment(start_idx, npars_[i]) = machines_[i]->GetParameters();
+    start_idx += npars_[i];
+  }
+  state["Parameters"] = pars;
+  WriteJsonToFile(state, filename);
+}
+
+void ProductMachine::Load(const std::string &filename) {
+  auto const pars = ReadJsonFromFile(filename);
+  if (pars.at("Name") != "ProductMachine") {
+    throw InvalidInputError(
+        "Error while constructing ProductMachine from Json input");
+  }
+  if (FieldExists(pars, "Nfactors") &&
+      pars["Nfactors"].get<std::size_t>() != machines_.size()) {
+    throw InvalidInputError(
+        "Number of factors is incompatible with the ProductMachine");
+  }
+  VectorType parameters = pars.at("Parameters");
+  if (parameters.size() != npar_) {
+    throw InvalidInputError(
+        "Number of parameters is incompatible with the ProductMachine");
+  }
+  SetParameters(parameters);
+}
+
+bool ProductMachine::IsHolomorphic() const noexcept {
+  for (auto const machine : machines_) {
+    if (!machine->IsHolomorphic()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace netket
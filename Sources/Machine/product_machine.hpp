@@ -0,0 +1,82 @@
+// Copyright 2018 The Simons Foundation, Inc. - All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef NETKET_PRODUCT_MACHINE_HPP
+#define NETKET_PRODUCT_MACHINE_HPP
+
+#include <vector>
+
+#include "Machine/abstract_machine.hpp"
+
+namespace netket {
+
+/** Product of several machines,
+ * psi(v) = psi_1(v) * psi_2(v) * ... * psi_n(v).
+ *
+ * The parameters (and the derivatives) are the concatenation of the ones of
+ * the factors, in the order in which the factors are given. The look-up table
+ * holds the look-up tables of all the factors, so that each of them keeps its
+ * own fast updates.
+ */
+class ProductMachine : public AbstractMachine {
+  // Factors, not owned by the product
+  std::vector<AbstractMachine *> machines_;
+
+  // Number of parameters of each factor
+  std::vector<int> npars_;
+
+  // Total number of parameters
+  int npar_;
+
+  // buffer
+  VectorType logvals_;
+
+ public:
+  ProductMachine(std::shared_ptr<const AbstractHilbert> hilbert,
+                 std::vector<AbstractMachine *> machines);
+
+  int Nvisible() const override;
+  int Npar() const override;
+
+  VectorType GetParameters() override;
+  void SetParameters(VectorConstRefType pars) override;
+
+  void LogVal(Eigen::Ref<const RowMatrix<double>> v, Eigen::Ref<VectorType> out,
+              const any &lt) override;
+  void DerLog(Eigen::Ref<const RowMatrix<double>> v,
+              Eigen::Ref<RowMatrix<Complex>> out, const any &lt) override;
+
+  any InitLookup(VisibleConstType v) override;
+  void UpdateLookup(VisibleConstType v, const std::vector<int> &tochange,
+                    const std::vector<double> &newconf, any &lt) override;
+  Complex LogValSingle(VisibleConstType v, const any &lt) override;
+
+  VectorType LogValDiff(
+      VisibleConstType v, const std::vector<std::vector<int>> &tochange,
+      const std::vector<std::vector<double>> &newconf) override;
+  Complex LogValDiff(VisibleConstType v, const std::vector<int> &tochange,
+                     const std::vector<double> &newconf,
+                     const any &lt) override;
+
+  VectorType DerLogSingle(VisibleConstType v, const any &lt) override;
+
+  void Save(const std::string &filename) const override;
+  void Load(const std::string &filename) override;
+
+  bool IsHolomorphic() const noexcept override;
+};
+
+}  // namespace netket
+
+#endif  // NETKET_PRODUCT_MACHINE_HPP
@@ -15,11 +15,13 @@
 #include "Machine/py_abstract_machine.hpp"
 
 #include <cstdio>
+#include <string>
 
 #include <pybind11/complex.h>
 #include <pybind11/eigen.h>
 #include <pybind11/pybind11.h>
 
+#include "Utils/exceptions.hpp"
 #include "Utils/messages.hpp"
 
 namespace netket {
@@ -72,6 +74,32 @@ auto ShouldNotThrow(Function &&function, Args &&... args) noexcept
                    // marked [[noreturn]]).
   }
 }
+
+/// Calls the Python implementation `name(v, out)` of a batched member
+/// function. Both `v` and `out` are passed as NumPy views of the Eigen
+/// buffers, so nothing is copied when the Python function writes its result
+/// into `out`. Python functions which return a new array instead are supported
+/// as well, at the cost of one copy.
+template <class Output>
+void CallBatched(const AbstractMachine *self, const char *name,
+                 Eigen::Ref<const RowMatrix<double>> v, Output &out) {
+  pybind11::gil_scoped_acquire gil;
+  auto overload = pybind11::get_overload(self, name);
+  if (!overload) {
+    pybind11::pybind11_fail(
+        std::string{"Tried to call pure virtual function \"AbstractMachine::"} +
+        name + "\"");
+  }
+  auto out_array =
+      pybind11::cast(out, pybind11::return_value_policy::reference);
+  auto result = overload(v, out_array);
+  if (!result.is_none() && !result.is(out_array)) {
+    auto const copy = result.cast<typename Output::PlainObject>();
+    CheckShape(name, "result", {copy.rows(), copy.cols()},
+               {out.rows(), out.cols()});
+    out = copy;
+  }
+}
 }  // namespace
 }  // namespace detail
 
@@ -125,11 +153,16 @@ void PyAbstractMachine::SetParameters(VectorConstRefType pars) {
 void PyAbstractMachine::LogVal(Eigen::Ref<const RowMatrix<double>> v,
                                Eigen::Ref<Eigen::VectorXcd> out,
                                const any & /*unused*/) {
-  PYBIND11_OVERLOAD_PURE_NAME(void,            /* Return type */
-                              AbstractMachine, /* Parent class */
-                              "log_val", /* Name of the function in Python */
-                              LogVal,    /* Name of function in C++ */
-                              v, out);
+  CheckShape(__FUNCTION__, "out", out.size(), v.rows());
+  detail::CallBatched(this, "log_val", v, out);
+}
+
+void PyAbstractMachine::DerLog(Eigen::Ref<const RowMatrix<double>> v,
+                               Eigen::Ref<RowMatrix<Complex>> out,
+                               const any & /*unused*/) {
+  CheckShape(__FUNCTION__, "out", {out.rows(), out.cols()},
+             {v.rows(), std::ignore});
+  detail::CallBatched(this, "der_log", v, out);
 }
 
 Complex PyAbstractMachine::LogValSingle(VisibleConstType v, const any &cache) {
@@ -146,14 +179,30 @@ void PyAbstractMachine::UpdateLookup(VisibleConstType /*unused*/,
                                      const std::vector<double> & /*unused*/,
                                      any & /*unused*/) {}
 
+PyAbstractMachine::VectorType PyAbstractMachine::LogValDiff(
+    VisibleConstType v, const std::vector<std::vector<int>> &tochange,
+    const std::vector<std::vector<double>> &newconf) {
+  // The first row holds v itself, so that all log-values are computed in a
+  // single call into Python.
+  RowMatrix<double> input(static_cast<Index>(tochange.size()) + 1, v.size());
+  input = v.transpose().colwise().replicate(input.rows());
+  for (auto i = Index{1}; i < input.rows(); ++i) {
+    GetHilbert().UpdateConf(input.row(i), tochange[static_cast<size_t>(i - 1)],
+                            newconf[static_cast<size_t>(i - 1)]);
+  }
+  VectorType log_vals(input.rows());
+  LogVal(input, log_vals, any{});
+  VectorType x = log_vals.tail(input.rows() - 1);
+  x.array() -= log_vals(0);
+  return x;
+}
+
 PyAbstractMachine::VectorType PyAbstractMachine::DerLogSingle(
-    VisibleConstType v, const any & /*lt*/) {
-  PYBIND11_OVERLOAD_PURE_NAME(
-      VectorType,       /* Return type */
-      AbstractMachine,  /* Parent class */
-      "der_log_single", /* Name of the function in Python */
-      DerLogSingle,     /* Name of function in C++ */
-      v);
+    VisibleConstType v, const any &cache) {
+  VectorType der(Npar());
+  auto out = Eigen::Map<RowMatrix<Complex>>(der.data(), 1, der.size());
+  DerLog(v.transpose(), out, cache);
+  return der;
 }
 
 PyAbstractMachine::VectorType PyAbstractMachine::DerLogChanged(
@@ -34,6 +34,9 @@ class PyAbstractMachine : public AbstractMachine {
   Complex LogValSingle(VisibleConstType v, const any & /*unused*/) override;
   void LogVal(Eigen::Ref<const RowMatrix<double>> v, Eigen::Ref<VectorXcd> out,
               const any & /*unused*/) override;
+  void DerLog(Eigen::Ref<const RowMatrix<double>> v,
+              Eigen::Ref<RowMatrix<Complex>> out,
+              const any & /*unused*/) override;
 
   any InitLookup(VisibleConstType /*unused*/) override;
   void UpdateLookup(VisibleConstType /*unused*/,
@@ -41,6 +44,10 @@ class PyAbstractMachine : public AbstractMachine {
                     const std::vector<double> & /*unused*/,
                     any & /*unused*/) override;
 
+  VectorType LogValDiff(
+      VisibleConstType v, const std::vector<std::vector<int>> &tochange,
+      const std::vector<std::vector<double>> &newconf) override;
+
   VectorType DerLogSingle(VisibleConstType v, const any & /*lt*/) override;
   VectorType DerLogChanged(VisibleConstType old_v,
                            const std::vector<int> &to_change,
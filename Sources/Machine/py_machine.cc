@@ -30,6 +30,7 @@
 #include "Machine/jastrow.hpp"
 #include "Machine/jastrow_symm.hpp"
 #include "Machine/mps_periodic.hpp"
+#include "Machine/product_machine.hpp"
 #include "Machine/py_abstract_machine.hpp"
 #include "Machine/rbm_multival.hpp"
 #include "Machine/rbm_spin.hpp"
@@ -354,6 +355,48 @@ void AddJastrowSymm(py::module subm) {
                  )EOF");
 }
 
+void AddProductMachine(py::module subm) {
+  py::class_<ProductMachine, AbstractMachine>(subm, "ProductMachine", R"EOF(
+           A product of machines. This machine defines the wavefunction
+
+           $$ \Psi(s_1,\dots s_N) = \prod_k \Psi_k(s_1,\dots s_N) $$
+
+           where $$ \Psi_k $$ are the given factors. Its parameters are the
+           parameters of all the factors, in the order in which the factors
+           are given. Look-up tables of the factors are kept, so that each
+           factor uses its own fast updates.)EOF")
+      .def(py::init([](std::shared_ptr<const AbstractHilbert> hi,
+                       py::tuple tuple) {
+             auto machines = py::cast<std::vector<AbstractMachine *>>(tuple);
+             return ProductMachine{std::move(hi), std::move(machines)};
+           }),
+           py::keep_alive<1, 3>(), py::arg("hilbert"), py::arg("machines"),
+           R"EOF(
+                 Constructs a new ``ProductMachine``:
+
+                 Args:
+                     hilbert: Hilbert space object for the system.
+                     machines: Tuple of machines defined on the same Hilbert
+                         space.
+
+                 Examples:
+                     A Jastrow factor times a ``RbmSpin`` for a
+                     one-dimensional L=20 spin 1/2 system:
+
+                     ```python
+                     >>> from netket.machine import Jastrow, RbmSpin, ProductMachine
+                     >>> from netket.hilbert import Spin
+                     >>> from netket.graph import Hypercube
+                     >>> g = Hypercube(length=20, n_dim=1)
+                     >>> hi = Spin(s=0.5, total_sz=0, graph=g)
+                     >>> ma = ProductMachine(hi, (Jastrow(hi), RbmSpin(hi, alpha=1)))
+                     >>> print(ma.n_par)
+                     630
+
+                     ```
+                 )EOF");
+}
+
 void AddMpsPeriodic(py::module subm) {
   py::class_<MPSPeriodic, AbstractMachine>(subm, "MPSPeriodic")
       .def(py::init<std::shared_ptr<const AbstractHilbert>, int, bool, int>(),
@@ -560,15 +603,20 @@ void AddLayerModule(py::module m) {
 void AddRbmSpinV2(py::module m) {
   py::class_<RbmSpinV2, AbstractMachine>(m, "RbmSpinV2")
       .def(py::init<std::shared_ptr<const AbstractHilbert>, Index, Index, bool,
-                    bool, Index>(),
+                    bool, Index, bool>(),
            py::arg("hilbert"), py::arg("n_hidden") = 0, py::arg("alpha") = 0,
            py::arg("use_visible_bias") = true,
-           py::arg("use_hidden_bias") = true, py::arg{"batch_size"} = 64)
+           py::arg("use_hidden_bias") = true, py::arg{"batch_size"} = 64,
+           py::arg{"single_precision"} = false)
       .def_property(
           "batch_size", [](const RbmSpinV2 &self) { return self.BatchSize(); },
           [](RbmSpinV2 &self, Index const batch_size) {
             self.BatchSize(batch_size);
-          });
+          })
+      .def_property_readonly(
+          "single_precision", &RbmSpinV2::IsSinglePrecision,
+          R"EOF(bool: Whether `log_val` and `der_log` are computed in single
+                precision. Parameters are always stored in double precision.)EOF");
 }
 
 void AddAbstractMachine(py::module m) {
@@ -600,7 +648,7 @@ void AddAbstractMachine(py::module m) {
               return py::cast(self.LogValSingle(input));
             }
             auto input = x.cast<Eigen::Ref<const RowMatrix<double>>>();
-            return py::cast(self.LogVal(input, any{}));
+            return py::object{MoveToNumpy(self.LogVal(input, any{}))};
           },
           py::arg("v"),
           R"EOF(
@@ -633,10 +681,10 @@ void AddAbstractMachine(py::module m) {
           [](AbstractMachine &self, py::array_t<double> x) {
             if (x.ndim() == 1) {
               auto input = x.cast<Eigen::Ref<const VectorXd>>();
-              return py::cast(self.DerLogSingle(input));
+              return MoveToNumpy(self.DerLogSingle(input));
             }
             auto input = x.cast<Eigen::Ref<const RowMatrix<double>>>();
-            return py::cast(self.DerLog(input, any{}));
+            return MoveToNumpy(self.DerLog(input, any{}));
           },
           py::arg("v"),
           R"EOF(
@@ -768,6 +816,7 @@ void AddMachineModule(py::module m) {
   AddJastrow(subm);
   AddJastrowSymm(subm);
   AddMpsPeriodic(subm);
+  AddProductMachine(subm);
   AddFFNN(subm);
   AddLayerModule(m);
   AddDensityMatrixModule(subm);
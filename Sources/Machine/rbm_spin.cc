@@ -14,7 +14,9 @@
 
 #include "rbm_spin.hpp"
 
+#include "Utils/exceptions.hpp"
 #include "Utils/json_utils.hpp"
+#include "Utils/log_cosh.hpp"
 #include "Utils/messages.hpp"
 
 namespace netket {
@@ -140,6 +142,20 @@ void RbmSpin::SetParameters(VectorConstRefType pars) {
   W_ = Eigen::Map<MatrixType>(Wpars.data(), nv_, nh_);
 }
 
+// Values of the logarithm of the wave-function for a batch of configurations
+void RbmSpin::LogVal(Eigen::Ref<const RowMatrix<double>> v,
+                     Eigen::Ref<VectorType> out, const any & /*unused*/) {
+  CheckShape(__FUNCTION__, "v", {v.rows(), v.cols()}, {std::ignore, nv_});
+  CheckShape(__FUNCTION__, "out", out.size(), v.rows());
+  // The thetas of the whole batch are computed with one GEMM
+  RowMatrix<Complex> thetas = v.cast<Complex>() * W_;
+  thetas.rowwise() += b_.transpose();
+  out.noalias() = v.cast<Complex>() * a_;
+  for (auto i = Index{0}; i < v.rows(); ++i) {
+    out(i) += SumLogCosh(thetas.row(i).transpose());
+  }
+}
+
 // Value of the logarithm of the wave-function
 // using pre-computed look-up tables for efficiency
 Complex RbmSpin::LogValSingle(VisibleConstType v, const any &lookup) {
@@ -213,6 +229,64 @@ Complex RbmSpin::LogValDiff(VisibleConstType v,
   return logvaldiff;
 }
 
+any RbmSpin::InitLookupBatch(Eigen::Ref<const RowMatrix<double>> v) {
+  CheckShape(__FUNCTION__, "v", {v.rows(), v.cols()}, {std::ignore, nv_});
+  BatchLookup lt;
+  lt.thetas = v.cast<Complex>() * W_;
+  lt.thetas.rowwise() += b_.transpose();
+  lt.lncosh_sums.resize(v.rows());
+  for (auto i = Index{0}; i < v.rows(); ++i) {
+    lt.lncosh_sums(i) = SumLogCosh(lt.thetas.row(i).transpose());
+  }
+  return any{std::move(lt)};
+}
+
+// Each move only touches a few rows of W, so the new thetas of a configuration
+// are obtained from the stored ones at O(nh) cost per changed unit
+void RbmSpin::LogValDiffBatch(Eigen::Ref<const RowMatrix<double>> v,
+                              const std::vector<std::vector<int>> &tochange,
+                              const std::vector<std::vector<double>> &newconf,
+                              const any &lookup, Eigen::Ref<VectorType> out) {
+  CheckShape(__FUNCTION__, "out", out.size(), v.rows());
+  const auto &lt = any_cast_ref<BatchLookup>(lookup);
+  for (auto i = Index{0}; i < v.rows(); ++i) {
+    const auto &sites = tochange[static_cast<std::size_t>(i)];
+    const auto &values = newconf[static_cast<std::size_t>(i)];
+    if (sites.empty()) {
+      out(i) = 0.;
+      continue;
+    }
+    Complex logvaldiff = 0.;
+    thetasnew_ = lt.thetas.row(i).transpose();
+    for (std::size_t s = 0; s < sites.size(); s++) {
+      const int sf = sites[s];
+      const double delta = values[s] - v(i, sf);
+      logvaldiff += a_(sf) * delta;
+      thetasnew_ += W_.row(sf).transpose() * delta;
+    }
+    out(i) = logvaldiff + SumLogCosh(thetasnew_) - lt.lncosh_sums(i);
+  }
+}
+
+void RbmSpin::UpdateLookupBatch(Eigen::Ref<const RowMatrix<double>> v,
+                                const std::vector<std::vector<int>> &tochange,
+                                const std::vector<std::vector<double>> &newconf,
+                                any &lookup) {
+  auto &lt = any_cast_ref<BatchLookup>(lookup);
+  for (auto i = Index{0}; i < v.rows(); ++i) {
+    const auto &sites = tochange[static_cast<std::size_t>(i)];
+    const auto &values = newconf[static_cast<std::size_t>(i)];
+    if (sites.empty()) {
+      continue;
+    }
+    for (std::size_t s = 0; s < sites.size(); s++) {
+      const int sf = sites[s];
+      lt.thetas.row(i) += W_.row(sf) * (values[s] - v(i, sf));
+    }
+    lt.lncosh_sums(i) = SumLogCosh(lt.thetas.row(i).transpose());
+  }
+}
+
 void RbmSpin::Save(const std::string &filename) const {
   json state;
   state["Name"] = "RbmSpin";
@@ -51,6 +51,14 @@ class RbmSpin : public AbstractMachine {
   bool usea_;
   bool useb_;
 
+  // Look-up tables for a batch of K configurations
+  struct BatchLookup {
+    // K x nh matrix of the hidden units' input (one row per configuration)
+    RowMatrix<Complex> thetas;
+    // Sum of lncosh(thetas) of every row
+    VectorType lncosh_sums;
+  };
+
  public:
   RbmSpin(std::shared_ptr<const AbstractHilbert> hilbert, int nhidden = 0,
           int alpha = 0, bool usea = true, bool useb = true);
@@ -63,6 +71,8 @@ class RbmSpin : public AbstractMachine {
   void UpdateLookup(VisibleConstType v, const std::vector<int> &tochange,
                     const std::vector<double> &newconf, any &lt) override;
   VectorType DerLogSingle(VisibleConstType v, const any &lt) override;
+  void LogVal(Eigen::Ref<const RowMatrix<double>> v, Eigen::Ref<VectorType> out,
+              const any &lt) override;
   Complex LogValSingle(VisibleConstType v, const any &lt) override;
 
   VectorType GetParameters() override;
@@ -81,6 +91,16 @@ class RbmSpin : public AbstractMachine {
                      const std::vector<double> &newconf,
                      const any &lt) override;
 
+  any InitLookupBatch(Eigen::Ref<const RowMatrix<double>> v) override;
+  void LogValDiffBatch(Eigen::Ref<const RowMatrix<double>> v,
+                       const std::vector<std::vector<int>> &tochange,
+                       const std::vector<std::vector<double>> &newconf,
+                       const any &lt, Eigen::Ref<VectorType> out) override;
+  void UpdateLookupBatch(Eigen::Ref<const RowMatrix<double>> v,
+                         const std::vector<std::vector<int>> &tochange,
+                         const std::vector<std::vector<double>> &newconf,
+                         any &lt) override;
+
   void Save(const std::string &filename) const override;
   void Load(const std::string &filename) override;
 
@@ -37,12 +37,14 @@ void RbmSpinSymm::RbmSpinSymm::Init(const AbstractGraph &graph) {
   permsize_ = permtable_.size();
   nh_ = (alpha_ * permsize_);
 
-  for (int i = 0; i < permsize_; i++) {
-    assert(int(permtable_[i].size()) == nv_);
+  invpermtable_.assign(permsize_, std::vector<int>(nv_));
+  for (int g = 0; g < permsize_; g++) {
+    assert(int(permtable_[g].size()) == nv_);
+    for (int i = 0; i < nv_; i++) {
+      invpermtable_[g][permtable_[g][i]] = i;
+    }
   }
 
-  W_.resize(nv_, nh_);
-  a_.resize(nv_);
   b_.resize(nh_);
 
   thetas_.resize(nh_);
@@ -50,6 +52,8 @@ void RbmSpinSymm::RbmSpinSymm::Init(const AbstractGraph &graph) {
   thetasnew_.resize(nh_);
   lnthetasnew_.resize(nh_);
 
+  vgathered_.resize(permsize_, nv_);
+
   Wsymm_.resize(nv_, alpha_);
   bsymm_.resize(alpha_);
 
@@ -61,7 +65,6 @@ void RbmSpinSymm::RbmSpinSymm::Init(const AbstractGraph &graph) {
     nbarepar_ += nv_;
   } else {
     asymm_ = 0;
-    a_.setZero();
   }
 
   if (useb_) {
@@ -72,45 +75,6 @@ void RbmSpinSymm::RbmSpinSymm::Init(const AbstractGraph &graph) {
     b_.setZero();
   }
 
-  // Constructing the matrix that maps the bare derivatives to the symmetric
-  // ones
-  DerMatSymm_ = Eigen::MatrixXd::Zero(npar_, nbarepar_);
-
-  int k = 0;
-  int kbare = 0;
-
-  if (usea_) {
-    // derivative with respect to a
-    for (int p = 0; p < nv_; p++) {
-      DerMatSymm_(k, p) = 1;
-      kbare++;
-    }
-    k++;
-  }
-
-  if (useb_) {
-    // derivatives with respect to b
-    for (int p = 0; p < nh_; p++) {
-      int ksymm = std::floor(double(p) / double(permsize_));
-      DerMatSymm_(ksymm + k, kbare) = 1;
-      kbare++;
-    }
-    k += alpha_;
-  }
-
-  // derivatives with respect to W
-  for (int i = 0; i < nv_; i++) {
-    for (int j = 0; j < nh_; j++) {
-      int isymm = permtable_.at(j % permsize_).at(i);
-      int jsymm = std::floor(double(j) / double(permsize_));
-      int ksymm = jsymm + alpha_ * isymm;
-
-      DerMatSymm_(ksymm + k, kbare) = 1;
-
-      kbare++;
-    }
-  }
-
   InfoMessage() << "RBM Initizialized with nvisible = " << nv_
                 << " and nhidden = " << nh_ << std::endl;
   InfoMessage() << "Symmetries are being used : " << npar_
@@ -121,10 +85,36 @@ int RbmSpinSymm::Nvisible() const { return nv_; }
 
 int RbmSpinSymm::Npar() const { return npar_; }
 
+void RbmSpinSymm::ComputeTheta(VisibleConstType v, VectorType &theta) {
+  // theta(s * permsize_ + g) = sum_i Wsymm_(permtable_[g][i], s) v(i)
+  //                          = sum_k Wsymm_(k, s) v(invpermtable_[g][k])
+  for (int g = 0; g < permsize_; g++) {
+    const auto &inv = invpermtable_[g];
+    for (int k = 0; k < nv_; k++) {
+      vgathered_(g, k) = v(inv[k]);
+    }
+  }
+  theta.resize(nh_);
+  Eigen::Map<MatrixType>{theta.data(), permsize_, alpha_}.noalias() =
+      vgathered_ * Wsymm_;
+  theta += b_;
+}
+
+void RbmSpinSymm::UpdateTheta(int site, double delta,
+                              VectorType &theta) const {
+  int j = 0;
+  for (int s = 0; s < alpha_; s++) {
+    for (int g = 0; g < permsize_; g++) {
+      theta(j) += Wsymm_(permtable_[g][site], s) * delta;
+      j++;
+    }
+  }
+}
+
 any RbmSpinSymm::InitLookup(VisibleConstType v) {
   LookupType lt;
   lt.AddVector(b_.size());
-  lt.V(0) = (W_.transpose() * v + b_);
+  ComputeTheta(v, lt.V(0));
   return any{std::move(lt)};
 }
 
@@ -136,40 +126,40 @@ void RbmSpinSymm::UpdateLookup(VisibleConstType v,
     auto &lt = any_cast_ref<LookupType>(lookup);
     for (std::size_t s = 0; s < tochange.size(); s++) {
       const int sf = tochange[s];
-      lt.V(0) += W_.row(sf) * (newconf[s] - v(sf));
+      UpdateTheta(sf, newconf[s] - v(sf), lt.V(0));
     }
   }
 }
 
-RbmSpinSymm::VectorType RbmSpinSymm::BareDerLog(VisibleConstType v) {
-  return BareDerLog(v, InitLookup(v));
-}
-
-RbmSpinSymm::VectorType RbmSpinSymm::BareDerLog(VisibleConstType v,
-                                                const any &lt) {
-  VectorType der(nbarepar_);
+RbmSpinSymm::VectorType RbmSpinSymm::DerLogImpl(VisibleConstType v,
+                                                const VectorType &theta) {
+  VectorType der = VectorType::Zero(npar_);
 
   int k = 0;
 
   if (usea_) {
-    for (; k < nv_; k++) {
-      der(k) = v(k);
-    }
+    der(k) = v.sum();
+    k++;
   }
 
-  RbmSpin::tanh(any_cast_ref<LookupType>(lt).V(0), lnthetas_);
+  RbmSpin::tanh(theta, lnthetas_);
 
   if (useb_) {
     for (int p = 0; p < nh_; p++) {
-      der(k) = lnthetas_(p);
-      k++;
+      der(k + p / permsize_) += lnthetas_(p);
     }
+    k += alpha_;
   }
 
-  for (int i = 0; i < nv_; i++) {
-    for (int j = 0; j < nh_; j++) {
-      der(k) = lnthetas_(j) * v(i);
-      k++;
+  // Maps the bare derivatives tanh(theta_j) v_i onto the symmetric
+  // parameters by scatter-adding through the permutation table
+  for (int g = 0; g < permsize_; g++) {
+    const auto &perm = permtable_[g];
+    for (int i = 0; i < nv_; i++) {
+      const int kk = k + alpha_ * perm[i];
+      for (int s = 0; s < alpha_; s++) {
+        der(kk + s) += lnthetas_(s * permsize_ + g) * v(i);
+      }
     }
   }
   return der;
@@ -177,8 +167,11 @@ RbmSpinSymm::VectorType RbmSpinSymm::BareDerLog(VisibleConstType v,
 
 RbmSpinSymm::VectorType RbmSpinSymm::DerLogSingle(VisibleConstType v,
                                                   const any &lt) {
-  if (lt.empty()) return DerMatSymm_ * BareDerLog(v);
-  return DerMatSymm_ * BareDerLog(v, lt);
+  if (lt.empty()) {
+    ComputeTheta(v, thetas_);
+    return DerLogImpl(v, thetas_);
+  }
+  return DerLogImpl(v, any_cast_ref<LookupType>(lt).V(0));
 }
 
 RbmSpinSymm::VectorType RbmSpinSymm::GetParameters() {
@@ -238,33 +231,23 @@ void RbmSpinSymm::SetParameters(VectorConstRefType pars) {
 }
 
 void RbmSpinSymm::SetBareParameters() {
-  // Setting the bare values of the RBM parameters
-  for (int i = 0; i < nv_; i++) {
-    a_(i) = asymm_;
-  }
-
+  // Only the hidden bias is expanded, bare weights are gathered on the fly
   for (int j = 0; j < nh_; j++) {
     int jsymm = std::floor(double(j) / double(permsize_));
     b_(j) = bsymm_(jsymm);
   }
-
-  for (int i = 0; i < nv_; i++) {
-    for (int j = 0; j < nh_; j++) {
-      int jsymm = std::floor(double(j) / double(permsize_));
-      W_(i, j) = Wsymm_(permtable_[j % permsize_][i], jsymm);
-    }
-  }
 }
 
 // Value of the logarithm of the wave-function
 // using pre-computed look-up tables for efficiency
 Complex RbmSpinSymm::LogValSingle(VisibleConstType v, const any &lt) {
   if (lt.empty()) {
-    RbmSpin::lncosh(W_.transpose() * v + b_, lnthetas_);
-    return (v.dot(a_) + lnthetas_.sum());
+    ComputeTheta(v, thetas_);
+    RbmSpin::lncosh(thetas_, lnthetas_);
+    return (asymm_ * v.sum() + lnthetas_.sum());
   }
   RbmSpin::lncosh(any_cast_ref<LookupType>(lt).V(0), lnthetas_);
-  return (v.dot(a_) + lnthetas_.sum());
+  return (asymm_ * v.sum() + lnthetas_.sum());
 }
 
 // Difference between logarithms of values, when one or more visible variables
@@ -275,7 +258,7 @@ RbmSpinSymm::VectorType RbmSpinSymm::LogValDiff(
   const std::size_t nconn = tochange.size();
   VectorType logvaldiffs = VectorType::Zero(nconn);
 
-  thetas_ = (W_.transpose() * v + b_);
+  ComputeTheta(v, thetas_);
   RbmSpin::lncosh(thetas_, lnthetas_);
 
   Complex logtsum = lnthetas_.sum();
@@ -287,9 +270,9 @@ RbmSpinSymm::VectorType RbmSpinSymm::LogValDiff(
       for (std::size_t s = 0; s < tochange[k].size(); s++) {
         const int sf = tochange[k][s];
 
-        logvaldiffs(k) += a_(sf) * (newconf[k][s] - v(sf));
+        logvaldiffs(k) += asymm_ * (newconf[k][s] - v(sf));
 
-        thetasnew_ += W_.row(sf) * (newconf[k][s] - v(sf));
+        UpdateTheta(sf, newconf[k][s] - v(sf), thetasnew_);
       }
 
       RbmSpin::lncosh(thetasnew_, lnthetasnew_);
@@ -317,9 +300,9 @@ Complex RbmSpinSymm::LogValDiff(VisibleConstType v,
     for (std::size_t s = 0; s < tochange.size(); s++) {
       const int sf = tochange[s];
 
-      logvaldiff += a_(sf) * (newconf[s] - v(sf));
+      logvaldiff += asymm_ * (newconf[s] - v(sf));
 
-      thetasnew_ += W_.row(sf) * (newconf[s] - v(sf));
+      UpdateTheta(sf, newconf[s] - v(sf), thetasnew_);
     }
 
     RbmSpin::lncosh(thetasnew_, lnthetasnew_);
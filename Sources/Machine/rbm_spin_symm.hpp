@@ -38,18 +38,17 @@ class RbmSpinSymm : public AbstractMachine {
   // number of parameters without symmetries
   int nbarepar_;
 
+  // permtable_[g][i] is the image of site i under symmetry g
   std::vector<std::vector<int>> permtable_;
+  // invpermtable_[g][permtable_[g][i]] == i
+  std::vector<std::vector<int>> invpermtable_;
   int permsize_;
 
-  // weights
-  MatrixType W_;
-
-  // weights with symmetries
+  // weights with symmetries. The bare weights W(i, j) are never stored
+  // explicitly, they are gathered as Wsymm_(permtable_[j % permsize_][i], j /
+  // permsize_)
   MatrixType Wsymm_;
 
-  // visible units bias
-  VectorType a_;
-
   Complex asymm_;
 
   // hidden units bias
@@ -62,7 +61,9 @@ class RbmSpinSymm : public AbstractMachine {
   VectorType thetasnew_;
   VectorType lnthetasnew_;
 
-  Eigen::MatrixXd DerMatSymm_;
+  // visible configuration gathered with the inverse permutations, one row per
+  // symmetry
+  Eigen::MatrixXd vgathered_;
 
   bool usea_;
   bool useb_;
@@ -100,8 +101,11 @@ class RbmSpinSymm : public AbstractMachine {
  private:
   inline void Init(const AbstractGraph &graph);
 
-  VectorType BareDerLog(VisibleConstType v);
-  VectorType BareDerLog(VisibleConstType v, const any &lt);
+  // Computes theta = W' * v + b as a convolution over the symmetry group
+  void ComputeTheta(VisibleConstType v, VectorType &theta);
+  // Performs theta += W.row(site) * delta
+  void UpdateTheta(int site, double delta, VectorType &theta) const;
+  VectorType DerLogImpl(VisibleConstType v, const VectorType &theta);
   void SetBareParameters();
 };
 
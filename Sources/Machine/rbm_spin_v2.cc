@@ -24,12 +24,13 @@ namespace netket {
 
 RbmSpinV2::RbmSpinV2(std::shared_ptr<const AbstractHilbert> hilbert,
                      Index nhidden, Index alpha, bool usea, bool useb,
-                     Index const batch_size)
+                     Index const batch_size, bool single_precision)
     : AbstractMachine{std::move(hilbert)},
       W_{},
       a_{nonstd::nullopt},
       b_{nonstd::nullopt},
-      theta_{} {
+      theta_{},
+      single_{nonstd::nullopt} {
   const auto nvisible = GetHilbert().Size();
   assert(nvisible >= 0 && "AbstractHilbert::Size is broken");
   if (nhidden < 0) {
@@ -61,6 +62,13 @@ RbmSpinV2::RbmSpinV2(std::shared_ptr<const AbstractHilbert> hilbert,
   }
 
   theta_.resize(batch_size, nhidden);
+
+  if (single_precision) {
+    single_.emplace();
+    single_->x.resize(batch_size, nvisible);
+    single_->theta.resize(batch_size, nhidden);
+    SyncSinglePrecision();
+  }
 }
 
 Index RbmSpinV2::BatchSize() const noexcept { return theta_.rows(); }
@@ -74,6 +82,20 @@ void RbmSpinV2::BatchSize(Index batch_size) {
   }
   if (batch_size != BatchSize()) {
     theta_.resize(batch_size, theta_.cols());
+    if (single_.has_value()) {
+      single_->x.resize(batch_size, single_->x.cols());
+      single_->theta.resize(batch_size, single_->theta.cols());
+    }
+  }
+}
+
+void RbmSpinV2::SyncSinglePrecision() {
+  if (!single_.has_value()) return;
+  single_->W = W_.cast<ComplexF>();
+  if (b_.has_value()) {
+    single_->b.emplace(b_->cast<ComplexF>());
+  } else {
+    single_->b = nonstd::nullopt;
   }
 }
 
@@ -106,6 +128,7 @@ void RbmSpinV2::SetParameters(Eigen::Ref<const Eigen::VectorXcd> parameters) {
   }
   Eigen::Map<Eigen::VectorXcd>(W_.data(), W_.size()) =
       parameters.segment(i, W_.size());
+  SyncSinglePrecision();
 }
 
 void RbmSpinV2::LogVal(Eigen::Ref<const RowMatrix<double>> x,
@@ -114,6 +137,10 @@ void RbmSpinV2::LogVal(Eigen::Ref<const RowMatrix<double>> x,
              {std::ignore, Nvisible()});
   CheckShape(__FUNCTION__, "out", out.size(), x.rows());
   BatchSize(x.rows());
+  if (single_.has_value()) {
+    LogValFloat(x, out);
+    return;
+  }
   if (a_.has_value()) {
     out.noalias() = x * (*a_);
   } else {
@@ -123,6 +150,31 @@ void RbmSpinV2::LogVal(Eigen::Ref<const RowMatrix<double>> x,
   ApplyBiasAndActivation(out);
 }
 
+void RbmSpinV2::LogValFloat(Eigen::Ref<const RowMatrix<double>> x,
+                            Eigen::Ref<Eigen::VectorXcd> out) {
+  assert(single_.has_value());
+  auto &single = *single_;
+  // The visible bias term is cheap, so we keep it in double precision.
+  if (a_.has_value()) {
+    out.noalias() = x * (*a_);
+  } else {
+    out.setZero();
+  }
+  single.x = x.cast<float>();
+  single.theta.noalias() = single.x * single.W;
+  if (single.b.has_value()) {
+#pragma omp parallel for schedule(static)
+    for (auto j = Index{0}; j < BatchSize(); ++j) {
+      out(j) += SumLogCosh(single.theta.row(j), *single.b);
+    }
+  } else {
+#pragma omp parallel for schedule(static)
+    for (auto j = Index{0}; j < BatchSize(); ++j) {
+      out(j) += SumLogCosh(single.theta.row(j));
+    }
+  }
+}
+
 void RbmSpinV2::DerLog(Eigen::Ref<const RowMatrix<double>> x,
                        Eigen::Ref<RowMatrix<Complex>> out,
                        const any & /*unused*/) {
@@ -130,6 +182,10 @@ void RbmSpinV2::DerLog(Eigen::Ref<const RowMatrix<double>> x,
              {std::ignore, Nvisible()});
   CheckShape(__FUNCTION__, "out", {out.rows(), out.cols()}, {x.rows(), Npar()});
   BatchSize(x.rows());
+  if (single_.has_value()) {
+    DerLogFloat(x, out);
+    return;
+  }
 
   auto i = Index{0};
   if (a_.has_value()) {
@@ -157,6 +213,36 @@ void RbmSpinV2::DerLog(Eigen::Ref<const RowMatrix<double>> x,
   }
 }
 
+void RbmSpinV2::DerLogFloat(Eigen::Ref<const RowMatrix<double>> x,
+                            Eigen::Ref<RowMatrix<Complex>> out) {
+  assert(single_.has_value());
+  auto &single = *single_;
+  auto i = Index{0};
+  if (a_.has_value()) {
+    out.block(0, i, BatchSize(), a_->size()) = x;
+    i += a_->size();
+  }
+
+  single.x = x.cast<float>();
+  single.theta.noalias() = single.x * single.W;
+  if (single.b.has_value()) {
+    single.theta.array() =
+        (single.theta + single.b->transpose().colwise().replicate(BatchSize()))
+            .array()
+            .tanh();
+    out.block(0, i, BatchSize(), b_->size()) = single.theta.cast<Complex>();
+    i += b_->size();
+  } else {
+    single.theta.array() = single.theta.array().tanh();
+  }
+
+#pragma omp parallel for schedule(static)
+  for (auto j = Index{0}; j < BatchSize(); ++j) {
+    Eigen::Map<Eigen::MatrixXcd>{&out(j, i), W_.rows(), W_.cols()}.noalias() =
+        (single.x.row(j).transpose() * single.theta.row(j)).cast<Complex>();
+  }
+}
+
 void RbmSpinV2::ApplyBiasAndActivation(Eigen::Ref<Eigen::VectorXcd> out) const {
   if (b_.has_value()) {
 #pragma omp parallel for schedule(static)
@@ -265,11 +351,14 @@ void Load(char const *name, T &parameter, pybind11::dict state) {
 }  // namespace detail
 
 void RbmSpinV2::Save(const std::string &filename) const {
+  // Save may be called from C++ drivers which run with the GIL released.
+  pybind11::gil_scoped_acquire gil;
   auto state = pybind11::reinterpret_steal<pybind11::dict>(StateDict());
   detail::WriteToFile(filename, state.ptr());
 }
 
 void RbmSpinV2::Load(const std::string &filename) {
+  pybind11::gil_scoped_acquire gil;
   // NOTE: conversion to dict is very important, since it performs error
   // checking! So don't just change object's type to `pybind11::object`. The
   // code will compile, but as soon as the user passes some weird type, the
@@ -316,6 +405,7 @@ void RbmSpinV2::StateDict(PyObject *obj) {
   detail::Load("a", a_, state);
   detail::Load("b", b_, state);
   detail::Load("w", W_, state);
+  SyncSinglePrecision();
 }
 
 }  // namespace netket
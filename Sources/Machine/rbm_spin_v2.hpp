@@ -29,8 +29,15 @@ namespace netket {
 
 class RbmSpinV2 : public AbstractMachine {
  public:
+  /// \brief Constructs a new RBM.
+  ///
+  /// \param single_precision if `true`, forward passes and derivatives are
+  /// computed in `complex<float>`. Parameters are still stored (and returned
+  /// by #GetParameters) in double precision and sums over hidden units are
+  /// accumulated in double precision.
   RbmSpinV2(std::shared_ptr<const AbstractHilbert> hilbert, Index nhidden,
-            Index alpha, bool usea, bool useb, Index const batch_size);
+            Index alpha, bool usea, bool useb, Index const batch_size,
+            bool single_precision = false);
 
   int Npar() const final {
     return W_.size() + (a_.has_value() ? a_->size() : 0) +
@@ -48,6 +55,9 @@ class RbmSpinV2 : public AbstractMachine {
   /// automatically on calls to `LogVal` and `DerLog`.
   void BatchSize(Index batch_size);
 
+  /// Returns whether computations are done in single precision.
+  bool IsSinglePrecision() const noexcept { return single_.has_value(); }
+
   VectorType GetParameters() final;
   void SetParameters(Eigen::Ref<const Eigen::VectorXcd> pars) final;
 
@@ -128,15 +138,38 @@ class RbmSpinV2 : public AbstractMachine {
   bool IsHolomorphic() const noexcept final { return true; }
 
  private:
+  using ComplexF = std::complex<float>;
+
+  /// Single-precision copies of the parameters and caches.
+  struct SinglePrecision {
+    Eigen::Matrix<ComplexF, Eigen::Dynamic, Eigen::Dynamic> W;
+    nonstd::optional<Eigen::Matrix<ComplexF, Eigen::Dynamic, 1>> b;
+    RowMatrix<float> x;
+    RowMatrix<ComplexF> theta;
+  };
+
   /// Performs `out := log(cosh(out + b))`.
   void ApplyBiasAndActivation(Eigen::Ref<Eigen::VectorXcd> out) const;
 
+  /// Single-precision versions of #LogVal and #DerLog.
+  void LogValFloat(Eigen::Ref<const RowMatrix<double>> x,
+                   Eigen::Ref<Eigen::VectorXcd> out);
+  void DerLogFloat(Eigen::Ref<const RowMatrix<double>> x,
+                   Eigen::Ref<RowMatrix<Complex>> out);
+
+  /// Copies #W_ and #b_ into #single_. Must be called whenever parameters
+  /// change.
+  void SyncSinglePrecision();
+
   Eigen::MatrixXcd W_;             ///< weights
   nonstd::optional<VectorXcd> a_;  ///< visible units bias
   nonstd::optional<VectorXcd> b_;  ///< hidden units bias
 
   /// Caches
   RowMatrix<Complex> theta_;
+
+  /// Only set in single-precision mode
+  nonstd::optional<SinglePrecision> single_;
 };
 
 }  // namespace netket
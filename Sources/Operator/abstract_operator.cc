@@ -29,6 +29,14 @@ AbstractOperator::GetConn(VectorConstRefType v) const {
                          std::move(newconfs));
 }
 
+Index AbstractOperator::CountConn(VectorConstRefType v) const {
+  MelType mel;
+  ConnectorsType connectors;
+  NewconfsType newconfs;
+  FindConn(v, mel, connectors, newconfs);
+  return static_cast<Index>(connectors.size());
+}
+
 void AbstractOperator::ForEachConn(VectorConstRefType v,
                                    ConnCallback callback) const {
   std::vector<Complex> weights;
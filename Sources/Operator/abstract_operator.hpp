@@ -83,6 +83,15 @@ class AbstractOperator {
   virtual std::tuple<MelType, ConnectorsType, NewconfsType> GetConn(
       VectorConstRefType v) const;
 
+  /**
+  Member function returning the number of connected elements of the Operator,
+  i.e. the size of the lists filled by FindConn(v, ...), without building them.
+  The default implementation calls FindConn, derived classes should override
+  it when the number can be obtained more cheaply.
+  @param v a constant reference to the visible configuration.
+  */
+  virtual Index CountConn(VectorConstRefType v) const;
+
   /**
    * Iterates over all states reachable from a given visible configuration v,
    * i.e., all states v' such that O(v,v') is non-zero.
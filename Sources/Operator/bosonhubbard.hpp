@@ -123,6 +123,22 @@ class BoseHubbard : public AbstractOperator {
       }
     }
   }
+
+  Index CountConn(VectorConstRefType v) const override {
+    // The diagonal element is always present
+    Index nconn = 1;
+    for (int i = 0; i < nsites_; i++) {
+      for (auto bond : bonds_[i]) {
+        if (v(i) > 0 && v(bond) < nmax_) {
+          ++nconn;
+        }
+        if (v(bond) > 0 && v(i) < nmax_) {
+          ++nconn;
+        }
+      }
+    }
+    return nconn;
+  }
 };
 
 }  // namespace netket
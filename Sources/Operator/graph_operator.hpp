@@ -116,6 +116,10 @@ class GraphOperator : public AbstractOperator {
     operator_.FindConn(v, mel, connectors, newconfs);
   }
 
+  Index CountConn(VectorConstRefType v) const override {
+    return operator_.CountConn(v);
+  }
+
   void ForEachConn(VectorConstRefType v, ConnCallback callback) const override {
     operator_.ForEachConn(v, callback);
   }
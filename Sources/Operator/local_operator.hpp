@@ -233,6 +233,17 @@ class LocalOperator : public AbstractOperator {
     }
   }
 
+  Index CountConn(VectorConstRefType v) const override {
+    assert(v.size() == GetHilbert().Size());
+
+    // The diagonal element is always present
+    Index nconn = 1;
+    for (std::size_t opn = 0; opn < nops_; opn++) {
+      nconn += connected_[opn][StateNumber(v, opn)].size();
+    }
+    return nconn;
+  }
+
   void ForEachConn(VectorConstRefType v, ConnCallback callback) const override {
     assert(v.size() == GetHilbert().Size());
 
@@ -112,17 +112,7 @@ class PauliOperator : public AbstractOperator {
     mel.clear();
     mel.resize(0);
     for (std::size_t i = 0; i < tochange_.size(); i++) {
-      std::complex<double> mel_temp = 0.0;
-      for (std::size_t j = 0; j < weights_[i].size(); j++) {
-        std::complex<double> m_temp = weights_[i][j];
-        for (auto k : zcheck_[i][j]) {
-          assert(k >= 0 && k < v.size());
-          if (int(std::round(v(k))) == 1) {
-            m_temp *= -1.;
-          }
-        }
-        mel_temp += m_temp;
-      }
+      const std::complex<double> mel_temp = MatrixElement(i, v);
       if (std::abs(mel_temp) > cutoff_) {
         std::vector<double> newconf_temp(tochange_[i].size());
         int jj = 0;
@@ -142,6 +132,37 @@ class PauliOperator : public AbstractOperator {
       }
     }
   }
+
+  Index CountConn(VectorConstRefType v) const override {
+    assert(v.size() == nqubits_);
+
+    Index nconn = 0;
+    for (std::size_t i = 0; i < tochange_.size(); i++) {
+      if (std::abs(MatrixElement(i, v)) > cutoff_) {
+        ++nconn;
+      }
+    }
+    return nconn;
+  }
+
+ private:
+  // Matrix element between v and the state obtained by flipping the qubits
+  // tochange_[i]
+  std::complex<double> MatrixElement(std::size_t i,
+                                     VectorConstRefType v) const {
+    std::complex<double> mel_temp = 0.0;
+    for (std::size_t j = 0; j < weights_[i].size(); j++) {
+      std::complex<double> m_temp = weights_[i][j];
+      for (auto k : zcheck_[i][j]) {
+        assert(k >= 0 && k < v.size());
+        if (int(std::round(v(k))) == 1) {
+          m_temp *= -1.;
+        }
+      }
+      mel_temp += m_temp;
+    }
+    return mel_temp;
+  }
 };
 
 }  // namespace netket
@@ -22,6 +22,7 @@
 #include <pybind11/stl_bind.h>
 #include <complex>
 #include <vector>
+#include "Utils/pybind_helpers.hpp"
 #include "abstract_operator.hpp"
 #include "py_bosonhubbard.hpp"
 #include "py_graph_operator.hpp"
@@ -49,6 +50,15 @@ void AddOperatorModule(py::module m) {
        will be several different connected visible units satisfying this
        condition, and they are denoted here v'(k), for k=0,1...N_connected.
 
+       Args:
+           v: A constant reference to the visible configuration.
+
+       )EOF")
+          .def("n_conn", &AbstractOperator::CountConn, py::arg("v"), R"EOF(
+       Member function returning the number of connected elements of the
+       Operator, i.e. the number of elements returned by ``get_conn(v)``,
+       without constructing them.
+
        Args:
            v: A constant reference to the visible configuration.
 
@@ -120,28 +130,36 @@ void AddOperatorModule(py::module m) {
                                                          << "; expected 3.");
             NETKET_CHECK(samples.shape(1) == log_values.shape(1),
                          InvalidInputError, "incompatible number of chains");
-            auto local_values = py::cast(LocalValues(
-                Eigen::Map<const RowMatrix<double>>{
-                    samples.data(), samples.shape(0) * samples.shape(1),
-                    samples.shape(2)},
-                Eigen::Map<const VectorXcd>{
-                    log_values.data(),
-                    log_values.shape(0) * log_values.shape(1)},
-                machine, op, batch_size));
-            local_values.attr("resize")(log_values.shape(0),
-                                        log_values.shape(1));
-            return local_values;
+            Eigen::Map<const RowMatrix<double>> samples_map{
+                samples.data(), samples.shape(0) * samples.shape(1),
+                samples.shape(2)};
+            Eigen::Map<const VectorXcd> log_values_map{
+                log_values.data(), log_values.shape(0) * log_values.shape(1)};
+            VectorXcd values;
+            {
+              py::gil_scoped_release release;
+              values = LocalValues(samples_map, log_values_map, machine, op,
+                                   batch_size);
+            }
+            return MoveToNumpy(std::move(values),
+                               {log_values.shape(0), log_values.shape(1)});
           }
-          case 1:
+          case 1: {
             NETKET_CHECK(samples.ndim() == 2, InvalidInputError,
                          "samples has wrong dimension: " << samples.ndim()
                                                          << "; expected 2.");
-            return py::cast(LocalValues(
-                Eigen::Map<const RowMatrix<double>>{
-                    samples.data(), samples.shape(0), samples.shape(1)},
-                Eigen::Map<const VectorXcd>{log_values.data(),
-                                            log_values.shape(0)},
-                machine, op, batch_size));
+            Eigen::Map<const RowMatrix<double>> samples_map{
+                samples.data(), samples.shape(0), samples.shape(1)};
+            Eigen::Map<const VectorXcd> log_values_map{log_values.data(),
+                                                       log_values.shape(0)};
+            VectorXcd values;
+            {
+              py::gil_scoped_release release;
+              values = LocalValues(samples_map, log_values_map, machine, op,
+                                   batch_size);
+            }
+            return MoveToNumpy(std::move(values));
+          }
           default:
             NETKET_CHECK(false, InvalidInputError,
                          "log_values has wrong dimension: "
@@ -15,9 +15,16 @@
 #ifndef NETKET_ABSTRACTSAMPLER_HPP
 #define NETKET_ABSTRACTSAMPLER_HPP
 
+#include <fstream>
 #include <functional>
 #include <memory>
+#include <sstream>
+#include <string>
+
+#include <mpi.h>
+
 #include "Machine/abstract_machine.hpp"
+#include "Utils/binary_io.hpp"
 
 namespace netket {
 
@@ -48,6 +55,7 @@ class AbstractSampler {
     NETKET_CHECK(machine_func, InvalidInputError,
                  "Invalid machine function in Sampler");
     machine_func_ = std::move(machine_func);
+    default_machine_func_ = false;
   }
 
   AbstractMachine& GetMachine() const noexcept { return psi_; }
@@ -56,8 +64,68 @@ class AbstractSampler {
     return machine_func_;
   }
 
+  /// Returns whether the machine function is the default one, F(Ψ) = |Ψ|².
+  bool HasDefaultMachineFunc() const noexcept { return default_machine_func_; }
+
   virtual Index BatchSize() const noexcept = 0;
 
+  /// \brief Returns whether all MPI processes hold the same Markov chains.
+  ///
+  /// This is the case when one chain is spread over all processes (e.g.
+  /// parallel tempering with a distributed ladder). Its samples must then be
+  /// counted only once, see Statistics().
+  virtual bool SharesChains() const noexcept { return false; }
+
+  /// \brief Saves the state of the sampler to \p filename.
+  ///
+  /// The state consists of the configurations of all Markov chains, the
+  /// state of the random number generator, the acceptance statistics and,
+  /// for parallel tempering, the temperature ladder. Look-up tables and
+  /// log-values are not stored, #LoadState() recomputes them. Every MPI
+  /// process writes its own file: \p filename when running on a single
+  /// process and `filename.<rank>` otherwise.
+  void SaveState(const std::string& filename) const {
+    const auto name = StateFilename(filename);
+    std::ofstream stream{name, std::ios::binary};
+    NETKET_CHECK(stream.is_open(), InvalidInputError,
+                 "cannot open file: " << name);
+    WriteBinary(stream, std::string{StateTag()});
+    std::ostringstream engine;
+    engine << engine_.Get();
+    WriteBinary(stream, engine.str());
+    SaveChains(stream);
+    NETKET_CHECK(stream.good(), RuntimeError,
+                 "failed to write sampler state to " << name);
+  }
+
+  /// \brief Restores a state written by #SaveState().
+  ///
+  /// The sampler must have the same type and settings (e.g. the batch size
+  /// or the number of replicas) as the one which was saved, and the
+  /// parameters of the machine should be loaded beforehand, since look-up
+  /// tables and log-values are recomputed from them. When running with MPI,
+  /// must be called by all processes.
+  void LoadState(const std::string& filename) {
+    const auto name = StateFilename(filename);
+    std::ifstream stream{name, std::ios::binary};
+    NETKET_CHECK(stream.is_open(), InvalidInputError,
+                 "cannot open file: " << name);
+    std::string tag;
+    ReadBinary(stream, tag);
+    NETKET_CHECK(tag == StateTag(), InvalidInputError,
+                 name << " does not contain a sampler state");
+    std::string engine;
+    ReadBinary(stream, engine);
+    std::istringstream engine_stream{engine};
+    engine_stream >> engine_.Get();
+    NETKET_CHECK(engine_stream, InvalidInputError,
+                 "invalid random engine state in " << name);
+    LoadChains(stream);
+    NETKET_CHECK(stream.peek() == std::char_traits<char>::eof(),
+                 InvalidInputError,
+                 name << " was written by a different sampler");
+  }
+
  protected:
   AbstractSampler(AbstractMachine& psi)
       : engine_{},
@@ -68,13 +136,37 @@ class AbstractSampler {
               std::transform(x.begin(), x.end(), out.begin(),
                              [](Complex z) { return std::norm(z); });
             }},
+        default_machine_func_{true},
         psi_{psi} {}
 
   default_random_engine& GetRandomEngine() { return engine_.Get(); }
 
+  /// Writes the state of the Markov chains for #SaveState().
+  virtual void SaveChains(std::ostream& stream) const = 0;
+
+  /// \brief Reads the state written by #SaveChains().
+  ///
+  /// Implementations are responsible for rebuilding the look-up tables and
+  /// log-values of the chains.
+  virtual void LoadChains(std::istream& stream) = 0;
+
  private:
+  static const char* StateTag() noexcept { return "netket-sampler-state-1"; }
+
+  static std::string StateFilename(const std::string& filename) {
+    int size;
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+    if (size == 1) {
+      return filename;
+    }
+    int rank;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    return filename + "." + std::to_string(rank);
+  }
+
   DistributedRandomEngine engine_;
   MachineFunction machine_func_;
+  bool default_machine_func_;
   AbstractMachine& psi_;
 };  // namespace netket
 
@@ -160,6 +252,19 @@ class LogValAccumulator {
     Reset(false);                                                   \
   }
 
+// Sets the replica at beta = 1. With a distributed ladder, all processes must
+// call it and the configuration of the process holding that replica is used.
+#define NETKET_SAMPLER_SET_VISIBLE_DEFAULT_PT(var, ladder)          \
+  void SetVisible(Eigen::Ref<const RowMatrix<double>> v) override { \
+    CheckShape(__FUNCTION__, "v", {v.rows(), v.cols()},             \
+               {1, GetMachine().Nvisible()});                       \
+    const int target = ladder.TargetReplica();                      \
+    if (target >= 0) {                                              \
+      var[target] = v.row(0);                                       \
+    }                                                               \
+    Reset(false);                                                   \
+  }
+
 #define NETKET_SAMPLER_ACCEPTANCE_DEFAULT(accepts, moves)                  \
   double Acceptance() const {                                              \
     NETKET_CHECK(moves > 0, RuntimeError,                                  \
@@ -174,6 +279,34 @@ class LogValAccumulator {
     return (accepts.array() / moves.array()).matrix();                     \
   }
 
+#define NETKET_SAMPLER_STATE_DEFAULT(var, accepts, moves) \
+  void SaveChains(std::ostream& stream) const override {  \
+    WriteBinary(stream, var);                             \
+    WriteBinary(stream, accepts);                         \
+    WriteBinary(stream, moves);                           \
+  }                                                       \
+  void LoadChains(std::istream& stream) override {        \
+    ReadBinary(stream, var);                              \
+    Reset(false);                                         \
+    ReadBinary(stream, accepts);                          \
+    ReadBinary(stream, moves);                            \
+  }
+
+#define NETKET_SAMPLER_STATE_DEFAULT_PT(var, accepts, moves, ladder) \
+  void SaveChains(std::ostream& stream) const override {             \
+    ladder.Save(stream);                                             \
+    WriteBinary(stream, var);                                        \
+    WriteBinary(stream, accepts);                                    \
+    WriteBinary(stream, moves);                                      \
+  }                                                                  \
+  void LoadChains(std::istream& stream) override {                   \
+    ladder.Load(stream);                                             \
+    ReadBinary(stream, var);                                         \
+    Reset(false);                                                    \
+    ReadBinary(stream, accepts);                                     \
+    ReadBinary(stream, moves);                                       \
+  }
+
 #define NETKET_SAMPLER_APPLY_MACHINE_FUNC(expr)                \
   [this](const Complex z) {                                    \
     double result;                                             \
@@ -167,6 +167,7 @@ class CustomSampler : public AbstractSampler {
 
   NETKET_SAMPLER_SET_VISIBLE_DEFAULT(v_)
   NETKET_SAMPLER_ACCEPTANCE_DEFAULT(accept_, moves_)
+  NETKET_SAMPLER_STATE_DEFAULT(v_, accept_, moves_)
 
   void SetSweepSize(int sweep_size) {
     if (sweep_size <= 0) {
@@ -0,0 +1,137 @@
+// Copyright 2019 The Simons Foundation, Inc. - All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "Sampler/custom_sampler_v2.hpp"
+
+#include <algorithm>
+
+#include "Sampler/custom_sampler.hpp"
+#include "Utils/memory_utils.hpp"
+#include "Utils/next_variation.hpp"
+
+namespace netket {
+
+namespace detail {
+namespace {
+Index MaxMoveSize(const LocalOperator& move_operators) {
+  CustomSampler::CheckMoveOperators(move_operators);
+  Index size = 0;
+  for (const auto& sites : move_operators.ActingOn()) {
+    size = std::max(size, static_cast<Index>(sites.size()));
+  }
+  return size;
+}
+}  // namespace
+
+MoveOperatorProposer::MoveOperatorProposer(
+    std::pair<Index, Index> const shape, const LocalOperator& move_operators,
+    const std::vector<double>& move_weights, const AbstractHilbert& hilbert,
+    default_random_engine& engine)
+    : Proposer{shape, MaxMoveSize(move_operators), hilbert, engine},
+      moves_{},
+      choice_{},
+      hilbert_states_{hilbert.LocalStates()} {
+  NETKET_CHECK(move_operators.GetHilbert().Size() == hilbert.Size(),
+               InvalidInputError,
+               "Move operators in CustomSamplerV2 act on a different hilbert "
+               "space than the Machine");
+  const auto& local_matrices = move_operators.LocalMatrices();
+  const auto& acting_on = move_operators.ActingOn();
+
+  if (move_weights.empty()) {
+    // By default the move operators are drawn uniformly
+    choice_ = AliasTable(std::vector<double>(local_matrices.size(), 1.0));
+  } else {
+    NETKET_CHECK(move_weights.size() == local_matrices.size(),
+                 InvalidInputError,
+                 "The custom sampler definition is inconsistent (between "
+                 "MoveWeights and MoveOperators sizes)");
+    choice_ = AliasTable(move_weights);
+  }
+
+  const auto local_size = static_cast<int>(hilbert_states_.size());
+  moves_.resize(local_matrices.size());
+  for (std::size_t c = 0; c < local_matrices.size(); ++c) {
+    auto& move = moves_[c];
+    const auto& mat = local_matrices[c];
+    move.sites.assign(acting_on[c].begin(), acting_on[c].end());
+
+    // Same ordering of the local states as in LocalOperator
+    move.states.resize(static_cast<Index>(mat.size()),
+                       static_cast<Index>(move.sites.size()));
+    std::vector<int> st(move.sites.size(), 0);
+    Index i = 0;
+    do {
+      for (std::size_t k = 0; k < st.size(); ++k) {
+        move.states(i, k) = hilbert_states_[st[k]];
+      }
+      ++i;
+    } while (netket::next_variation(st.begin(), st.end(), local_size - 1));
+    assert(i == move.states.rows());
+
+    move.transitions.reserve(mat.size());
+    std::vector<double> weights(mat.size());
+    for (const auto& row : mat) {
+      std::transform(row.begin(), row.end(), weights.begin(),
+                     [](Complex x) { return x.real(); });
+      move.transitions.emplace_back(weights);
+    }
+  }
+  Reset();
+}
+
+Index MoveOperatorProposer::LocalIndex(const Move& move, const Index j) const {
+  const auto local_size = static_cast<Index>(hilbert_states_.size());
+  Index index = 0;
+  for (const auto site : move.sites) {
+    const auto it = std::find(hilbert_states_.begin(), hilbert_states_.end(),
+                              state_(j, site));
+    assert(it != hilbert_states_.end());
+    index = index * local_size + (it - hilbert_states_.begin());
+  }
+  return index;
+}
+
+void MoveOperatorProposer::Draw() {
+  for (auto j = Index{0}; j < BatchSize(); ++j) {
+    const auto& move = moves_[choice_(engine_)];
+    const auto next = move.transitions[LocalIndex(move, j)](engine_);
+    // Only the sites whose quantum numbers change are part of the move. In
+    // particular, staying in the current state is an empty move.
+    Index size = 0;
+    for (std::size_t k = 0; k < move.sites.size(); ++k) {
+      const auto value = move.states(next, static_cast<Index>(k));
+      if (value != state_(j, move.sites[k])) {
+        sites_(j, size) = move.sites[k];
+        new_values_(j, size) = value;
+        ++size;
+      }
+    }
+    MoveSize(j, size);
+  }
+}
+}  // namespace detail
+
+CustomSamplerV2::CustomSamplerV2(AbstractMachine& machine,
+                                 const LocalOperator& move_operators,
+                                 const std::vector<double>& move_weights,
+                                 const Index batch_size,
+                                 const Index sweep_size, const bool use_lookup)
+    : MetropolisV2{machine, batch_size, sweep_size, use_lookup} {
+  Init(make_unique<detail::MoveOperatorProposer>(
+      std::make_pair(batch_size, Nvisible()), move_operators, move_weights,
+      machine.GetHilbert(), GetRandomEngine()));
+}
+
+}  // namespace netket
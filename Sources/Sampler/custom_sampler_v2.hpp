@@ -0,0 +1,80 @@
+// Copyright 2019 The Simons Foundation, Inc. - All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SOURCES_SAMPLER_CUSTOM_SAMPLER_V2_HPP
+#define SOURCES_SAMPLER_CUSTOM_SAMPLER_V2_HPP
+
+#include <vector>
+
+#include "Operator/local_operator.hpp"
+#include "Sampler/metropolis_local_v2.hpp"
+#include "Utils/random_utils.hpp"
+
+namespace netket {
+
+namespace detail {
+/// \brief Suggests moves drawn from user-defined stochastic move operators.
+///
+/// The local matrices of the move operators are compiled once into
+/// transition tables, so that drawing a move only requires computing the
+/// index of the current local state and sampling from an AliasTable.
+class MoveOperatorProposer : public Proposer {
+ public:
+  MoveOperatorProposer(std::pair<Index, Index> shape,
+                       const LocalOperator& move_operators,
+                       const std::vector<double>& move_weights,
+                       const AbstractHilbert& hilbert,
+                       default_random_engine& engine);
+
+ protected:
+  void Draw() override;
+
+ private:
+  /// A move operator compiled to transition tables.
+  struct Move {
+    /// Sites the operator acts on.
+    std::vector<Index> sites;
+    /// A matrix of size `number of local states x sites.size()` which maps
+    /// an index of the local matrix to the quantum numbers of #sites.
+    RowMatrix<double> states;
+    /// For every local state, the distribution of the next local state.
+    std::vector<AliasTable> transitions;
+  };
+
+  /// Returns the index of the local state of #sites of the \p j'th Markov
+  /// chain in the local matrix of \p move.
+  Index LocalIndex(const Move& move, Index j) const;
+
+  std::vector<Move> moves_;
+  /// Distribution of the move operators.
+  AliasTable choice_;
+  /// Local quantum numbers in the order used by the local matrices.
+  std::vector<double> hilbert_states_;
+};
+}  // namespace detail
+
+/// \brief Batched version of CustomSampler.
+///
+/// Runs #BatchSize() Markov chains whose moves are drawn from user-defined
+/// stochastic move operators.
+class CustomSamplerV2 : public MetropolisV2 {
+ public:
+  CustomSamplerV2(AbstractMachine& machine, const LocalOperator& move_operators,
+                  const std::vector<double>& move_weights, Index batch_size,
+                  Index sweep_size, bool use_lookup = false);
+};
+
+}  // namespace netket
+
+#endif  // SOURCES_SAMPLER_CUSTOM_SAMPLER_V2_HPP
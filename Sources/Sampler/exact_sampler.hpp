@@ -27,9 +27,9 @@ class ExactSampler : public AbstractSampler {
   // number of visible units
   const int nv_;
 
-  // states of visible units
-  Eigen::VectorXd v_;
-  int state_index_;
+  // states of visible units, one per row
+  RowMatrix<double> v_;
+  Eigen::VectorXcd log_vals_;
 
   int mynode_;
   int totalnodes_;
@@ -38,22 +38,27 @@ class ExactSampler : public AbstractSampler {
 
   const int dim_;
 
-  std::discrete_distribution<int> dist_;
+  AliasTable dist_;
 
   std::vector<Complex> logpsivals_;
-  std::vector<double> psivals_;
 
  public:
-  explicit ExactSampler(AbstractMachine& psi)
+  explicit ExactSampler(AbstractMachine& psi, Index batch_size = 1)
       : AbstractSampler(psi),
         nv_(GetMachine().GetHilbert().Size()),
         hilbert_index_(GetMachine().GetHilbert().GetIndex()),
         dim_(hilbert_index_.NStates()) {
-    Init();
+    Init(batch_size);
   }
 
-  void Init() {
-    v_.resize(nv_);
+  void Init(Index batch_size) {
+    if (batch_size < 1) {
+      std::ostringstream msg;
+      msg << "invalid batch size: " << batch_size << "; expected >=1";
+      throw InvalidInputError{msg.str()};
+    }
+    v_.resize(batch_size, nv_);
+    log_vals_.resize(batch_size);
 
     MPI_Comm_size(MPI_COMM_WORLD, &totalnodes_);
     MPI_Comm_rank(MPI_COMM_WORLD, &mynode_);
@@ -70,52 +75,93 @@ class ExactSampler : public AbstractSampler {
   }
 
   void Reset(bool initrandom) override {
-    double logmax = -std::numeric_limits<double>::infinity();
+    // The basis is enumerated in chunks, so that the machine can evaluate
+    // many states at once
+    const int kChunkSize = 4096;
 
     logpsivals_.resize(dim_);
-    psivals_.resize(dim_);
 
-    for (int i = 0; i < dim_; ++i) {
-      auto v = hilbert_index_.NumberToState(i);
-      logpsivals_[i] = GetMachine().LogValSingle(v);
-      logmax = std::max(logmax, std::real(logpsivals_[i]));
+    RowMatrix<double> states(std::min(kChunkSize, dim_), nv_);
+    for (int start = 0; start < dim_; start += kChunkSize) {
+      const int n = std::min(kChunkSize, dim_ - start);
+#pragma omp parallel for schedule(static)
+      for (int i = 0; i < n; ++i) {
+        hilbert_index_.NumberToState(start + i, states.row(i));
+      }
+      GetMachine().LogVal(states.topRows(n),
+                          Eigen::Map<Eigen::VectorXcd>{&logpsivals_[start], n},
+                          any{});
     }
 
-    for (int i = 0; i < dim_; ++i) {
-      psivals_[i] =
-          NETKET_SAMPLER_APPLY_MACHINE_FUNC(std::exp(logpsivals_[i] - logmax));
+    const auto logpsi = Eigen::Map<const Eigen::ArrayXcd>{logpsivals_.data(),
+                                                          dim_};
+    const double logmax = logpsi.real().maxCoeff();
+
+    std::vector<double> psivals(dim_);
+    if (HasDefaultMachineFunc()) {
+      Eigen::Map<Eigen::ArrayXd>{psivals.data(), dim_} =
+          (2. * (logpsi.real() - logmax)).exp();
+    } else {
+      Eigen::ArrayXcd quotients(std::min(kChunkSize, dim_));
+      for (int start = 0; start < dim_; start += kChunkSize) {
+        const int n = std::min(kChunkSize, dim_ - start);
+        quotients.head(n) = (logpsi.segment(start, n) - logmax).exp();
+        GetMachineFunc()(nonstd::span<const Complex>{quotients.data(), n},
+                         nonstd::span<double>{&psivals[start], n});
+      }
     }
 
-    dist_ = std::discrete_distribution<int>(psivals_.begin(), psivals_.end());
+    dist_ = AliasTable(psivals);
 
     if (initrandom) {
-      state_index_ = dist_(this->GetRandomEngine());
-      v_ = hilbert_index_.NumberToState(state_index_);
+      Sweep();
+    } else {
+      // The machine may have changed, so the log-values of the current states
+      // are read again
+      for (Index b = 0; b < v_.rows(); ++b) {
+        log_vals_(b) = logpsivals_[hilbert_index_.StateToNumber(v_.row(b))];
+      }
     }
   }
 
   void Sweep() override {
-    state_index_ = dist_(this->GetRandomEngine());
-    v_ = hilbert_index_.NumberToState(state_index_);
+    for (Index b = 0; b < v_.rows(); ++b) {
+      const int state_index = dist_(this->GetRandomEngine());
+      hilbert_index_.NumberToState(state_index, v_.row(b));
+      log_vals_(b) = logpsivals_[state_index];
+    }
   }
 
   std::pair<Eigen::Ref<const RowMatrix<double>>,
             Eigen::Ref<const Eigen::VectorXcd>>
   CurrentState() const override {
-    return {v_.transpose(),
-            Eigen::Map<const Eigen::VectorXcd>{&logpsivals_[state_index_], 1}};
+    return {v_, log_vals_};
   }
 
   void SetVisible(Eigen::Ref<const RowMatrix<double>> v) override {
     CheckShape(__FUNCTION__, "v", {v.rows(), v.cols()},
-               {1, GetMachine().Nvisible()});
-    v_ = v.row(0);
-    state_index_ = hilbert_index_.StateToNumber(v_);
+               {v_.rows(), GetMachine().Nvisible()});
+    v_ = v;
+    for (Index b = 0; b < v_.rows(); ++b) {
+      log_vals_(b) = logpsivals_[hilbert_index_.StateToNumber(v_.row(b))];
+    }
   }
 
   double Acceptance() const noexcept { return 1; }
 
-  Index BatchSize() const noexcept override { return 1; }
+  void SaveChains(std::ostream& stream) const override {
+    WriteBinary(stream, v_);
+  }
+
+  void LoadChains(std::istream& stream) override {
+    RowMatrix<double> v(v_.rows(), v_.cols());
+    ReadBinary(stream, v);
+    // The distribution depends on the parameters of the machine
+    Reset(false);
+    SetVisible(v);
+  }
+
+  Index BatchSize() const noexcept override { return v_.rows(); }
 
   void SetMachineFunc(MachineFunction machine_func) override {
     AbstractSampler::SetMachineFunc(machine_func);
@@ -0,0 +1,134 @@
+// Copyright 2019 The Simons Foundation, Inc. - All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "Sampler/metropolis_cluster_v2.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include "Utils/memory_utils.hpp"
+
+namespace netket {
+
+namespace detail {
+ClusterFlipper::ClusterFlipper(std::pair<Index, Index> const shape,
+                               const AbstractGraph& graph,
+                               const double bond_probability,
+                               const bool antiferromagnetic,
+                               const bool conserve_total,
+                               const AbstractHilbert& hilbert,
+                               default_random_engine& engine)
+    : Proposer{shape, shape.second, hilbert, engine},
+      adjacency_{graph.AdjacencyList()},
+      bond_probability_{bond_probability},
+      antiferromagnetic_{antiferromagnetic},
+      conserve_total_{conserve_total},
+      state_index_(static_cast<std::size_t>(shape.second)),
+      in_cluster_(static_cast<std::size_t>(shape.second)) {
+  NETKET_CHECK(graph.Nsites() == Nvisible(), InvalidInputError,
+               "graph has " << graph.Nsites() << " sites, but there are "
+                            << Nvisible() << " visible units");
+  // With p = 1 clusters are whole domains, which can merge but never split
+  NETKET_CHECK(bond_probability >= 0. && bond_probability < 1.,
+               InvalidInputError,
+               "invalid bond probability: " << bond_probability
+                                            << "; expected a number in [0, 1)");
+  // Flipping more than two local states would never change some of them
+  // (e.g. m = 0 for spin 1), so the chains would not be ergodic
+  NETKET_CHECK(local_states_.size() == 2, InvalidInputError,
+               "cluster moves require exactly two local states, but there are "
+                   << local_states_.size());
+  // Ferromagnetic clusters and single sites always change the sum of the
+  // quantum numbers
+  NETKET_CHECK(!conserve_total || (antiferromagnetic && bond_probability > 0.),
+               InvalidInputError,
+               "conserving the total requires antiferromagnetic clusters and a "
+               "positive bond probability");
+  Reset();
+}
+
+void ClusterFlipper::Draw() {
+  for (auto j = Index{0}; j < BatchSize(); ++j) {
+    Grow(j);
+  }
+}
+
+void ClusterFlipper::Grow(const Index j) {
+  for (auto i = Index{0}; i < Nvisible(); ++i) {
+    state_index_[i] = std::lower_bound(local_states_.begin(),
+                                       local_states_.end(), state_(j, i)) -
+                      local_states_.begin();
+  }
+  std::fill(in_cluster_.begin(), in_cluster_.end(), 0);
+
+  // The row of sites_ doubles as the queue of the breadth-first search
+  const auto seed =
+      std::uniform_int_distribution<Index>{0, Nvisible() - 1}(engine_);
+  sites_(j, 0) = seed;
+  in_cluster_[seed] = 1;
+  Index size = 1;
+  std::uniform_real_distribution<double> uniform;
+  for (auto head = Index{0}; head < size; ++head) {
+    const auto a = sites_(j, head);
+    for (const auto b : adjacency_[a]) {
+      if (!in_cluster_[b] && Satisfied(state_index_[a], state_index_[b]) &&
+          uniform(engine_) < bond_probability_) {
+        in_cluster_[b] = 1;
+        sites_(j, size++) = b;
+      }
+    }
+  }
+
+  // Bonds inside the cluster stay satisfied (or not) when it is flipped, so
+  // only the bonds leaving it enter the ratio of proposal probabilities
+  Index delta = 0;
+  double change = 0.;
+  for (auto k = Index{0}; k < size; ++k) {
+    const auto a = sites_(j, k);
+    const auto flipped = Flipped() - state_index_[a];
+    new_values_(j, k) = local_states_[flipped];
+    change += new_values_(j, k) - state_(j, a);
+    for (const auto b : adjacency_[a]) {
+      if (!in_cluster_[b]) {
+        delta += Satisfied(flipped, state_index_[b]);
+        delta -= Satisfied(state_index_[a], state_index_[b]);
+      }
+    }
+  }
+
+  if (conserve_total_ && std::abs(change) > 1e-8) {
+    // Proposes to stay in the current configuration instead
+    MoveSize(j, 0);
+    proposal_ratios_(j) = 1.;
+    return;
+  }
+  MoveSize(j, size);
+  proposal_ratios_(j) =
+      std::pow(1. - bond_probability_, static_cast<double>(delta));
+}
+}  // namespace detail
+
+MetropolisClusterV2::MetropolisClusterV2(
+    AbstractMachine& machine, const AbstractGraph& graph,
+    const double bond_probability, const bool antiferromagnetic,
+    const bool conserve_total, const Index batch_size, const Index sweep_size,
+    const bool use_lookup)
+    : MetropolisV2{machine, batch_size, sweep_size, use_lookup} {
+  Init(make_unique<detail::ClusterFlipper>(
+      std::make_pair(batch_size, Nvisible()), graph, bond_probability,
+      antiferromagnetic, conserve_total, machine.GetHilbert(),
+      GetRandomEngine()));
+}
+
+}  // namespace netket
@@ -0,0 +1,90 @@
+// Copyright 2019 The Simons Foundation, Inc. - All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SOURCES_SAMPLER_METROPOLIS_CLUSTER_V2_HPP
+#define SOURCES_SAMPLER_METROPOLIS_CLUSTER_V2_HPP
+
+#include <vector>
+
+#include "Graph/abstract_graph.hpp"
+#include "Sampler/metropolis_local_v2.hpp"
+
+namespace netket {
+
+namespace detail {
+/// \brief Suggests flipping clusters of sites grown along the edges of a
+/// graph, as in the Wolff algorithm.
+///
+/// There must be exactly two local states (e.g. spin 1/2), flipping swaps
+/// them. A cluster starts at a random site, and every satisfied bond between
+/// a site of the cluster and one outside of it adds the latter with
+/// probability `p < 1`. A bond is satisfied if both sites hold the same
+/// quantum number (ferromagnetic clusters) or different ones
+/// (antiferromagnetic clusters, which are natural for bipartite graphs).
+///
+/// Since the clusters do not depend on the machine, the proposal is not
+/// symmetric: the ratio of the reverse and forward proposal probabilities is
+/// `(1 - p)^(A' - A)`, where `A` and `A'` are the numbers of satisfied bonds
+/// leaving the cluster before and after the flip.
+class ClusterFlipper : public Proposer {
+ public:
+  ClusterFlipper(std::pair<Index, Index> shape, const AbstractGraph& graph,
+                 double bond_probability, bool antiferromagnetic,
+                 bool conserve_total, const AbstractHilbert& hilbert,
+                 default_random_engine& engine);
+
+ protected:
+  void Draw() override;
+
+ private:
+  /// Grows a cluster in the `j`th Markov chain and proposes to flip it.
+  void Grow(Index j);
+
+  bool Satisfied(Index a, Index b) const noexcept {
+    return antiferromagnetic_ ? a + b == Flipped() : a == b;
+  }
+
+  /// `k` is flipped to `Flipped() - k`.
+  static constexpr Index Flipped() noexcept { return 1; }
+
+  std::vector<std::vector<int>> adjacency_;
+  double bond_probability_;
+  bool antiferromagnetic_;
+  /// Whether only clusters which leave the sum of the quantum numbers
+  /// unchanged are flipped.
+  bool conserve_total_;
+
+  /// Indices into #local_states_ of the quantum numbers of the current chain.
+  std::vector<Index> state_index_;
+  std::vector<char> in_cluster_;
+};
+}  // namespace detail
+
+/// \brief Metropolis sampling with Wolff-like cluster moves.
+///
+/// Runs #BatchSize() Markov chains which flip clusters of sites connected by
+/// satisfied bonds (see detail::ClusterFlipper). For Hilbert spaces with a
+/// fixed total magnetization \p conserve_total must be `true`: clusters which
+/// would change it are then not flipped, and they must be antiferromagnetic.
+class MetropolisClusterV2 : public MetropolisV2 {
+ public:
+  MetropolisClusterV2(AbstractMachine& machine, const AbstractGraph& graph,
+                      double bond_probability, bool antiferromagnetic,
+                      bool conserve_total, Index batch_size, Index sweep_size,
+                      bool use_lookup = false);
+};
+
+}  // namespace netket
+
+#endif  // SOURCES_SAMPLER_METROPOLIS_CLUSTER_V2_HPP
@@ -146,6 +146,7 @@ class MetropolisExchange : public AbstractSampler {
 
   NETKET_SAMPLER_SET_VISIBLE_DEFAULT(v_)
   NETKET_SAMPLER_ACCEPTANCE_DEFAULT(accept_, moves_)
+  NETKET_SAMPLER_STATE_DEFAULT(v_, accept_, moves_)
 };
 
 }  // namespace netket
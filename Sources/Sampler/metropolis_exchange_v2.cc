@@ -0,0 +1,136 @@
+// Copyright 2019 The Simons Foundation, Inc. - All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "Sampler/metropolis_exchange_v2.hpp"
+
+#include "Utils/memory_utils.hpp"
+
+namespace netket {
+
+namespace detail {
+RowMatrix<Index> TwoSiteClusters(const AbstractGraph& graph, const int dmax,
+                                 const bool ordered) {
+  const auto dist = graph.AllDistances();
+  std::vector<std::pair<Index, Index>> pairs;
+  for (auto i = std::size_t{0}; i < dist.size(); ++i) {
+    for (auto j = i + 1; j < dist.size(); ++j) {
+      if (dist[i][j] <= dmax) {
+        pairs.emplace_back(i, j);
+        if (ordered) {
+          pairs.emplace_back(j, i);
+        }
+      }
+    }
+  }
+  if (pairs.empty()) {
+    std::ostringstream msg;
+    msg << "invalid maximal distance: " << dmax
+        << "; there are no pairs of sites within this distance";
+    throw InvalidInputError{msg.str()};
+  }
+
+  RowMatrix<Index> clusters(static_cast<Index>(pairs.size()), 2);
+  for (auto k = Index{0}; k < clusters.rows(); ++k) {
+    std::tie(clusters(k, 0), clusters(k, 1)) =
+        pairs[static_cast<std::size_t>(k)];
+  }
+  return clusters;
+}
+
+TwoSiteProposer::TwoSiteProposer(std::pair<Index, Index> const shape,
+                                 RowMatrix<Index> clusters,
+                                 const AbstractHilbert& hilbert,
+                                 default_random_engine& engine)
+    : Proposer{shape, 2, hilbert, engine}, clusters_{std::move(clusters)} {
+  assert(clusters_.cols() == 2 && clusters_.rows() > 0);
+  NETKET_CHECK((clusters_.array() < Nvisible()).all(), InvalidInputError,
+               "graph has more sites than there are visible units");
+  Reset();
+}
+
+void TwoSiteProposer::RandomClusters() {
+  std::uniform_int_distribution<Index> distribution{0, clusters_.rows() - 1};
+  for (auto j = Index{0}; j < BatchSize(); ++j) {
+    sites_.row(j) = clusters_.row(distribution(engine_));
+  }
+}
+
+Exchanger::Exchanger(std::pair<Index, Index> const shape,
+                     const AbstractGraph& graph, const int dmax,
+                     const AbstractHilbert& hilbert,
+                     default_random_engine& engine)
+    : TwoSiteProposer{shape, TwoSiteClusters(graph, dmax, /*ordered=*/false),
+                      hilbert, engine} {}
+
+void Exchanger::Draw() {
+  RandomClusters();
+  // If both sites hold the same quantum number, the move is a no-op. We still
+  // propose it rather than drawing another cluster, because redrawing would
+  // bias the choice of clusters (and never terminate for uniform states).
+  for (auto j = Index{0}; j < BatchSize(); ++j) {
+    new_values_(j, 0) = state_(j, sites_(j, 1));
+    new_values_(j, 1) = state_(j, sites_(j, 0));
+  }
+}
+
+Hopper::Hopper(std::pair<Index, Index> const shape, const AbstractGraph& graph,
+               const int dmax, const AbstractHilbert& hilbert,
+               default_random_engine& engine)
+    : TwoSiteProposer{shape, TwoSiteClusters(graph, dmax, /*ordered=*/true),
+                      hilbert, engine} {
+  if (local_states_.size() < 2) {
+    throw InvalidInputError{
+        "MetropolisHopV2 requires at least two local states"};
+  }
+}
+
+void Hopper::Draw() {
+  RandomClusters();
+  std::uniform_int_distribution<std::size_t> distribution{
+      0, local_states_.size() - 1};
+  for (auto j = Index{0}; j < BatchSize(); ++j) {
+    // Makes sure that the new state is not equal to the current one
+    do {
+      new_values_(j, 0) = local_states_[distribution(engine_)];
+      new_values_(j, 1) = local_states_[distribution(engine_)];
+    } while (new_values_(j, 0) == state_(j, sites_(j, 0)) &&
+             new_values_(j, 1) == state_(j, sites_(j, 1)));
+  }
+}
+}  // namespace detail
+
+MetropolisExchangeV2::MetropolisExchangeV2(AbstractMachine& machine,
+                                           const AbstractGraph& graph,
+                                           const int dmax,
+                                           const Index batch_size,
+                                           const Index sweep_size,
+                                           const bool use_lookup)
+    : MetropolisV2{machine, batch_size, sweep_size, use_lookup} {
+  Init(make_unique<detail::Exchanger>(std::make_pair(batch_size, Nvisible()),
+                                      graph, dmax, machine.GetHilbert(),
+                                      GetRandomEngine()));
+}
+
+MetropolisHopV2::MetropolisHopV2(AbstractMachine& machine,
+                                 const AbstractGraph& graph, const int dmax,
+                                 const Index batch_size,
+                                 const Index sweep_size,
+                                 const bool use_lookup)
+    : MetropolisV2{machine, batch_size, sweep_size, use_lookup} {
+  Init(make_unique<detail::Hopper>(std::make_pair(batch_size, Nvisible()),
+                                   graph, dmax, machine.GetHilbert(),
+                                   GetRandomEngine()));
+}
+
+}  // namespace netket
@@ -0,0 +1,95 @@
+// Copyright 2019 The Simons Foundation, Inc. - All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SOURCES_SAMPLER_METROPOLIS_EXCHANGE_V2_HPP
+#define SOURCES_SAMPLER_METROPOLIS_EXCHANGE_V2_HPP
+
+#include "Graph/abstract_graph.hpp"
+#include "Sampler/metropolis_local_v2.hpp"
+
+namespace netket {
+
+namespace detail {
+/// \brief Returns all pairs of sites `(i, j)` with `i < j` (or `i != j` if
+/// \p ordered is `true`) such that the graph distance between `i` and `j` is
+/// at most \p dmax.
+///
+/// Each row of the returned matrix describes one pair.
+RowMatrix<Index> TwoSiteClusters(const AbstractGraph& graph, int dmax,
+                                 bool ordered);
+
+/// \brief Base class for proposers which change the quantum numbers of two
+/// sites at a time.
+class TwoSiteProposer : public Proposer {
+ public:
+  TwoSiteProposer(std::pair<Index, Index> shape, RowMatrix<Index> clusters,
+                  const AbstractHilbert& hilbert,
+                  default_random_engine& engine);
+
+ protected:
+  /// Fills #sites_ with clusters chosen uniformly from #clusters_.
+  void RandomClusters();
+
+ private:
+  /// A matrix of size `number of clusters x 2`.
+  RowMatrix<Index> clusters_;
+};
+
+/// Suggests exchanging the quantum numbers of two sites.
+class Exchanger : public TwoSiteProposer {
+ public:
+  Exchanger(std::pair<Index, Index> shape, const AbstractGraph& graph,
+            int dmax, const AbstractHilbert& hilbert,
+            default_random_engine& engine);
+
+ protected:
+  void Draw() override;
+};
+
+/// Suggests new random quantum numbers for two sites.
+class Hopper : public TwoSiteProposer {
+ public:
+  Hopper(std::pair<Index, Index> shape, const AbstractGraph& graph, int dmax,
+         const AbstractHilbert& hilbert, default_random_engine& engine);
+
+ protected:
+  void Draw() override;
+};
+}  // namespace detail
+
+/// \brief Batched version of MetropolisExchange.
+///
+/// Runs #BatchSize() Markov chains which exchange the quantum numbers of two
+/// sites within graph distance `dmax` of each other.
+class MetropolisExchangeV2 : public MetropolisV2 {
+ public:
+  MetropolisExchangeV2(AbstractMachine& machine, const AbstractGraph& graph,
+                       int dmax, Index batch_size, Index sweep_size,
+                       bool use_lookup = false);
+};
+
+/// \brief Batched version of MetropolisHop.
+///
+/// Runs #BatchSize() Markov chains which change the quantum numbers of two
+/// sites within graph distance `dmax` of each other.
+class MetropolisHopV2 : public MetropolisV2 {
+ public:
+  MetropolisHopV2(AbstractMachine& machine, const AbstractGraph& graph,
+                  int dmax, Index batch_size, Index sweep_size,
+                  bool use_lookup = false);
+};
+
+}  // namespace netket
+
+#endif  // SOURCES_SAMPLER_METROPOLIS_EXCHANGE_V2_HPP
@@ -39,14 +39,12 @@ class MetropolisHamiltonian : public AbstractSampler {
   // Look-up tables
   any lt_;
 
+  // Connected elements of the current state v_, they are only recomputed
+  // when a move is accepted
   std::vector<std::vector<int>> tochange_;
   std::vector<std::vector<double>> newconfs_;
   std::vector<Complex> mel_;
 
-  std::vector<std::vector<int>> tochange1_;
-  std::vector<std::vector<double>> newconfs1_;
-  std::vector<Complex> mel1_;
-
   Eigen::VectorXd v1_;
 
   int sweep_size_;
@@ -89,14 +87,13 @@ class MetropolisHamiltonian : public AbstractSampler {
 
     lt_ = GetMachine().InitLookup(v_);
     log_val_accumulator_ = GetMachine().LogValSingle(v_, lt_);
+    hamiltonian_.FindConn(v_, mel_, tochange_, newconfs_);
     accept_ = 0;
     moves_ = 0;
   }
 
   void Sweep() override {
     for (int i = 0; i < sweep_size_; i++) {
-      hamiltonian_.FindConn(v_, mel_, tochange_, newconfs_);
-
       const double w1 = tochange_.size();
 
       std::uniform_int_distribution<int> distrs(0, tochange_.size() - 1);
@@ -109,9 +106,8 @@ class MetropolisHamiltonian : public AbstractSampler {
       v1_ = v_;
       GetMachine().GetHilbert().UpdateConf(v1_, tochange_[si], newconfs_[si]);
 
-      hamiltonian_.FindConn(v1_, mel1_, tochange1_, newconfs1_);
-
-      double w2 = tochange1_.size();
+      // Only the number of reverse moves is needed here
+      const double w2 = hamiltonian_.CountConn(v1_);
 
       const auto lvd =
           GetMachine().LogValDiff(v_, tochange_[si], newconfs_[si], lt_);
@@ -134,6 +130,7 @@ class MetropolisHamiltonian : public AbstractSampler {
         GetMachine().UpdateLookup(v_, tochange_[si], newconfs_[si], lt_);
         v_ = v1_;
         log_val_accumulator_ += lvd;
+        hamiltonian_.FindConn(v_, mel_, tochange_, newconfs_);
 
 #ifndef NDEBUG
         const auto psival2 = GetMachine().LogValSingle(v_);
@@ -159,6 +156,7 @@ class MetropolisHamiltonian : public AbstractSampler {
 
   NETKET_SAMPLER_SET_VISIBLE_DEFAULT(v_)
   NETKET_SAMPLER_ACCEPTANCE_DEFAULT(accept_, moves_)
+  NETKET_SAMPLER_STATE_DEFAULT(v_, accept_, moves_)
 
   Index BatchSize() const noexcept override { return 1; }
 };
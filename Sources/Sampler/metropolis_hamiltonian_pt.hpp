@@ -17,6 +17,7 @@
 
 #include <Eigen/Core>
 #include "Sampler/abstract_sampler.hpp"
+#include "Sampler/temperature_ladder.hpp"
 #include "Utils/messages.hpp"
 #include "Utils/random_utils.hpp"
 
@@ -31,7 +32,7 @@ class MetropolisHamiltonianPt : public AbstractSampler {
   const int nv_;
 
   const int nrep_;
-  std::vector<double> beta_;
+  TemperatureLadder beta_;
 
   // states of visible units
   std::vector<Eigen::VectorXd> v_;
@@ -43,17 +44,22 @@ class MetropolisHamiltonianPt : public AbstractSampler {
   // Look-up tables
   std::vector<any> lt_;
 
-  std::vector<std::vector<int>> tochange_;
-  std::vector<std::vector<double>> newconfs_;
-  std::vector<Complex> mel_;
+  // Connected elements of a state
+  struct Connections {
+    std::vector<std::vector<int>> tochange;
+    std::vector<std::vector<double>> newconfs;
+    std::vector<Complex> mel;
+  };
 
-  std::vector<std::vector<int>> tochange1_;
-  std::vector<std::vector<double>> newconfs1_;
-  std::vector<Complex> mel1_;
+  // Connected elements of the states of all replicas, they are only
+  // recomputed when a local move is accepted
+  std::vector<Connections> conn_;
 
   int sweep_size_;
 
-  LogValAccumulator log_val_accumulator_;
+  // Log-values of all replicas, so that exchanges do not need to recompute
+  // them
+  std::vector<LogValAccumulator> log_val_accumulators_;
 
  public:
   MetropolisHamiltonianPt(AbstractMachine &psi, H &hamiltonian, int nrep)
@@ -76,14 +82,13 @@ class MetropolisHamiltonianPt : public AbstractSampler {
       v_[i].resize(nv_);
     }
 
-    for (int i = 0; i < nrep_; i++) {
-      beta_.push_back(1. - double(i) / double(nrep_));
-    }
+    beta_.Resize(nrep_);
 
     accept_.resize(2 * nrep_);
     moves_.resize(2 * nrep_);
 
     lt_.resize(nrep_);
+    conn_.resize(nrep_);
 
     Reset(true);
 
@@ -107,22 +112,34 @@ class MetropolisHamiltonianPt : public AbstractSampler {
       }
     }
 
+    log_val_accumulators_.resize(nrep_);
     for (int i = 0; i < nrep_; i++) {
       lt_[i] = GetMachine().InitLookup(v_[i]);
+      log_val_accumulators_[i] = GetMachine().LogValSingle(v_[i], lt_[i]);
+      FindConn(i);
     }
-    log_val_accumulator_ = GetMachine().LogValSingle(v_[0], lt_[0]);
 
     accept_ = Eigen::VectorXd::Zero(2 * nrep_);
     moves_ = Eigen::VectorXd::Zero(2 * nrep_);
+
+    if (beta_.IsDistributed()) {
+      beta_.SyncTarget(v_, log_val_accumulators_);
+    }
+  }
+
+  void FindConn(int rep) {
+    auto &conn = conn_[rep];
+    hamiltonian_.FindConn(v_[rep], conn.mel, conn.tochange, conn.newconfs);
   }
 
   void LocalSweep(int rep) {
     for (int i = 0; i < sweep_size_; i++) {
-      hamiltonian_.FindConn(v_[rep], mel_, tochange_, newconfs_);
+      const auto &tochange = conn_[rep].tochange;
+      const auto &newconfs = conn_[rep].newconfs;
 
-      const double w1 = tochange_.size();
+      const double w1 = tochange.size();
 
-      std::uniform_int_distribution<int> distrs(0, tochange_.size() - 1);
+      std::uniform_int_distribution<int> distrs(0, tochange.size() - 1);
       std::uniform_real_distribution<double> distu(0, 1);
 
       // picking a random state to transit to
@@ -130,14 +147,13 @@ class MetropolisHamiltonianPt : public AbstractSampler {
 
       // Inverse transition
       v1_ = v_[rep];
-      GetMachine().GetHilbert().UpdateConf(v1_, tochange_[si], newconfs_[si]);
-
-      hamiltonian_.FindConn(v1_, mel1_, tochange1_, newconfs1_);
+      GetMachine().GetHilbert().UpdateConf(v1_, tochange[si], newconfs[si]);
 
-      double w2 = tochange1_.size();
+      // Only the number of reverse moves is needed here
+      const double w2 = hamiltonian_.CountConn(v1_);
 
-      const auto lvd = GetMachine().LogValDiff(v_[rep], tochange_[si],
-                                               newconfs_[si], lt_[rep]);
+      const auto lvd = GetMachine().LogValDiff(v_[rep], tochange[si],
+                                               newconfs[si], lt_[rep]);
       double ratio =
           NETKET_SAMPLER_APPLY_MACHINE_FUNC(std::exp(beta_[rep] * lvd)) * w1 /
           w2;
@@ -157,12 +173,11 @@ class MetropolisHamiltonianPt : public AbstractSampler {
       // Metropolis acceptance test
       if (ratio > distu(this->GetRandomEngine())) {
         accept_(rep) += 1;
-        GetMachine().UpdateLookup(v_[rep], tochange_[si], newconfs_[si],
+        GetMachine().UpdateLookup(v_[rep], tochange[si], newconfs[si],
                                   lt_[rep]);
         v_[rep] = v1_;
-        if (rep == 0) {
-          log_val_accumulator_ += lvd;
-        }
+        log_val_accumulators_[rep] += lvd;
+        FindConn(rep);
 
 #ifndef NDEBUG
         const auto psival2 = GetMachine().LogValSingle(v_[rep]);
@@ -186,34 +201,50 @@ class MetropolisHamiltonianPt : public AbstractSampler {
       LocalSweep(i);
     }
 
-    // Tempearture exchanges
-    std::uniform_real_distribution<double> distribution(0, 1);
-
-    for (int r = 1; r < nrep_; r += 2) {
-      if (ExchangeProb(r, r - 1) > distribution(this->GetRandomEngine())) {
-        Exchange(r, r - 1);
-        accept_(nrep_ + r) += 1.;
-        accept_(nrep_ + r - 1) += 1;
+    // Temperature exchanges
+    if (beta_.IsDistributed()) {
+      beta_.ExchangeDistributed(
+          log_val_accumulators_,
+          [this](Complex x) { return NETKET_SAMPLER_APPLY_MACHINE_FUNC(x); },
+          accept_.tail(nrep_), moves_.tail(nrep_), this->GetRandomEngine());
+      beta_.SyncTarget(v_, log_val_accumulators_);
+    } else {
+      std::uniform_real_distribution<double> distribution(0, 1);
+
+      for (int r = 1; r < nrep_; r += 2) {
+        const bool accepted =
+            ExchangeProb(r, r - 1) > distribution(this->GetRandomEngine());
+        if (accepted) {
+          Exchange(r, r - 1);
+          accept_(nrep_ + r) += 1.;
+          accept_(nrep_ + r - 1) += 1;
+        }
+        beta_.Record(r, accepted);
+        moves_(nrep_ + r) += 1.;
+        moves_(nrep_ + r - 1) += 1;
       }
-      moves_(nrep_ + r) += 1.;
-      moves_(nrep_ + r - 1) += 1;
-    }
 
-    for (int r = 2; r < nrep_; r += 2) {
-      if (ExchangeProb(r, r - 1) > distribution(this->GetRandomEngine())) {
-        Exchange(r, r - 1);
-        accept_(nrep_ + r) += 1.;
-        accept_(nrep_ + r - 1) += 1;
+      for (int r = 2; r < nrep_; r += 2) {
+        const bool accepted =
+            ExchangeProb(r, r - 1) > distribution(this->GetRandomEngine());
+        if (accepted) {
+          Exchange(r, r - 1);
+          accept_(nrep_ + r) += 1.;
+          accept_(nrep_ + r - 1) += 1;
+        }
+        beta_.Record(r, accepted);
+        moves_(nrep_ + r) += 1.;
+        moves_(nrep_ + r - 1) += 1;
       }
-      moves_(nrep_ + r) += 1.;
-      moves_(nrep_ + r - 1) += 1;
     }
+
+    beta_.EndSweep();
   }
 
   // computes the probability to exchange two replicas
   double ExchangeProb(int r1, int r2) {
-    const auto lf1 = GetMachine().LogValSingle(v_[r1], lt_[r1]);
-    const auto lf2 = GetMachine().LogValSingle(v_[r2], lt_[r2]);
+    const auto lf1 = log_val_accumulators_[r1].LogVal();
+    const auto lf2 = log_val_accumulators_[r2].LogVal();
 
     return NETKET_SAMPLER_APPLY_MACHINE_FUNC(
         std::exp((beta_[r1] - beta_[r2]) * (lf2 - lf1)));
@@ -222,22 +253,39 @@ class MetropolisHamiltonianPt : public AbstractSampler {
   void Exchange(int r1, int r2) {
     std::swap(v_[r1], v_[r2]);
     std::swap(lt_[r1], lt_[r2]);
-    if (r1 == 0 || r2 == 0) {
-      log_val_accumulator_ = GetMachine().LogValSingle(v_[0], lt_[0]);
-    }
+    std::swap(conn_[r1], conn_[r2]);
+    std::swap(log_val_accumulators_[r1], log_val_accumulators_[r2]);
   }
 
   std::pair<Eigen::Ref<const RowMatrix<double>>,
             Eigen::Ref<const Eigen::VectorXcd>>
   CurrentState() const override {
+    if (beta_.IsDistributed()) {
+      return beta_.Target();
+    }
     return {v_[0].transpose(), Eigen::Map<const Eigen::VectorXcd>{
-                                   &log_val_accumulator_.LogVal(), 1}};
+                                   &log_val_accumulators_[0].LogVal(), 1}};
   }
 
-  NETKET_SAMPLER_SET_VISIBLE_DEFAULT(v_[0])
+  NETKET_SAMPLER_SET_VISIBLE_DEFAULT_PT(v_, beta_)
   NETKET_SAMPLER_ACCEPTANCE_DEFAULT_PT(accept_, moves_)
+  NETKET_SAMPLER_STATE_DEFAULT_PT(v_, accept_, moves_, beta_)
+
+  TemperatureLadder& Ladder() noexcept { return beta_; }
+  const TemperatureLadder& Ladder() const noexcept { return beta_; }
+
+  /// \brief Spreads one temperature ladder over all MPI processes.
+  ///
+  /// See TemperatureLadder::SetDistributed(). Must be called by all
+  /// processes.
+  void SetDistributed(bool distributed) {
+    beta_.SetDistributed(distributed);
+    Reset(false);
+  }
 
   Index BatchSize() const noexcept override { return 1; }
+
+  bool SharesChains() const noexcept override { return beta_.IsDistributed(); }
 };
 
 }  // namespace netket
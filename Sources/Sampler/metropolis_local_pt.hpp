@@ -17,6 +17,7 @@
 
 #include <Eigen/Core>
 #include "Sampler/abstract_sampler.hpp"
+#include "Sampler/temperature_ladder.hpp"
 #include "Utils/messages.hpp"
 #include "Utils/random_utils.hpp"
 
@@ -43,14 +44,16 @@ class MetropolisLocalPt : public AbstractSampler {
 
   int nrep_;
 
-  std::vector<double> beta_;
+  TemperatureLadder beta_;
 
   int nstates_;
   std::vector<double> localstates_;
 
   int sweep_size_;
 
-  LogValAccumulator log_val_accumulator_;
+  // Log-values of all replicas, so that exchanges do not need to recompute
+  // them
+  std::vector<LogValAccumulator> log_val_accumulators_;
 
  public:
   // Constructor with one replica by default
@@ -86,9 +89,7 @@ class MetropolisLocalPt : public AbstractSampler {
       v_[i].resize(nv_);
     }
 
-    for (int i = 0; i < nrep_; i++) {
-      beta_.push_back(1. - double(i) / double(nrep_));
-    }
+    beta_.Resize(nrep_);
 
     lt_.resize(nrep_);
 
@@ -105,13 +106,18 @@ class MetropolisLocalPt : public AbstractSampler {
       }
     }
 
+    log_val_accumulators_.resize(nrep_);
     for (int i = 0; i < nrep_; i++) {
       lt_[i] = GetMachine().InitLookup(v_[i]);
+      log_val_accumulators_[i] = GetMachine().LogValSingle(v_[i], lt_[i]);
     }
-    log_val_accumulator_ = GetMachine().LogValSingle(v_[0], lt_[0]);
 
     accept_ = Eigen::VectorXd::Zero(2 * nrep_);
     moves_ = Eigen::VectorXd::Zero(2 * nrep_);
+
+    if (beta_.IsDistributed()) {
+      beta_.SyncTarget(v_, log_val_accumulators_);
+    }
   }
 
   // Exchange sweep at given temperature
@@ -162,9 +168,7 @@ class MetropolisLocalPt : public AbstractSampler {
 
         GetMachine().UpdateLookup(v_[rep], tochange, newconf, lt_[rep]);
         GetMachine().GetHilbert().UpdateConf(v_[rep], tochange, newconf);
-        if (rep == 0) {
-          log_val_accumulator_ += lvd;
-        }
+        log_val_accumulators_[rep] += lvd;
 
 #ifndef NDEBUG
         const auto psival2 = GetMachine().LogValSingle(v_[rep]);
@@ -188,34 +192,50 @@ class MetropolisLocalPt : public AbstractSampler {
       LocalSweep(i);
     }
 
-    // Tempearture exchanges
-    std::uniform_real_distribution<double> distribution(0, 1);
-
-    for (int r = 1; r < nrep_; r += 2) {
-      if (ExchangeProb(r, r - 1) > distribution(this->GetRandomEngine())) {
-        Exchange(r, r - 1);
-        accept_(nrep_ + r) += 1.;
-        accept_(nrep_ + r - 1) += 1;
+    // Temperature exchanges
+    if (beta_.IsDistributed()) {
+      beta_.ExchangeDistributed(
+          log_val_accumulators_,
+          [this](Complex x) { return NETKET_SAMPLER_APPLY_MACHINE_FUNC(x); },
+          accept_.tail(nrep_), moves_.tail(nrep_), this->GetRandomEngine());
+      beta_.SyncTarget(v_, log_val_accumulators_);
+    } else {
+      std::uniform_real_distribution<double> distribution(0, 1);
+
+      for (int r = 1; r < nrep_; r += 2) {
+        const bool accepted =
+            ExchangeProb(r, r - 1) > distribution(this->GetRandomEngine());
+        if (accepted) {
+          Exchange(r, r - 1);
+          accept_(nrep_ + r) += 1.;
+          accept_(nrep_ + r - 1) += 1;
+        }
+        beta_.Record(r, accepted);
+        moves_(nrep_ + r) += 1.;
+        moves_(nrep_ + r - 1) += 1;
       }
-      moves_(nrep_ + r) += 1.;
-      moves_(nrep_ + r - 1) += 1;
-    }
 
-    for (int r = 2; r < nrep_; r += 2) {
-      if (ExchangeProb(r, r - 1) > distribution(this->GetRandomEngine())) {
-        Exchange(r, r - 1);
-        accept_(nrep_ + r) += 1.;
-        accept_(nrep_ + r - 1) += 1;
+      for (int r = 2; r < nrep_; r += 2) {
+        const bool accepted =
+            ExchangeProb(r, r - 1) > distribution(this->GetRandomEngine());
+        if (accepted) {
+          Exchange(r, r - 1);
+          accept_(nrep_ + r) += 1.;
+          accept_(nrep_ + r - 1) += 1;
+        }
+        beta_.Record(r, accepted);
+        moves_(nrep_ + r) += 1.;
+        moves_(nrep_ + r - 1) += 1;
       }
-      moves_(nrep_ + r) += 1.;
-      moves_(nrep_ + r - 1) += 1;
     }
+
+    beta_.EndSweep();
   }
 
   // computes the probability to exchange two replicas
   double ExchangeProb(int r1, int r2) {
-    const auto lf1 = GetMachine().LogValSingle(v_[r1], lt_[r1]);
-    const auto lf2 = GetMachine().LogValSingle(v_[r2], lt_[r2]);
+    const auto lf1 = log_val_accumulators_[r1].LogVal();
+    const auto lf2 = log_val_accumulators_[r2].LogVal();
 
     return NETKET_SAMPLER_APPLY_MACHINE_FUNC(
         std::exp((beta_[r1] - beta_[r2]) * (lf2 - lf1)));
@@ -224,22 +244,38 @@ class MetropolisLocalPt : public AbstractSampler {
   void Exchange(int r1, int r2) {
     std::swap(v_[r1], v_[r2]);
     std::swap(lt_[r1], lt_[r2]);
-    if (r1 == 0 || r2 == 0) {
-      log_val_accumulator_ = GetMachine().LogValSingle(v_[0], lt_[0]);
-    }
+    std::swap(log_val_accumulators_[r1], log_val_accumulators_[r2]);
   }
 
   std::pair<Eigen::Ref<const RowMatrix<double>>,
             Eigen::Ref<const Eigen::VectorXcd>>
   CurrentState() const override {
+    if (beta_.IsDistributed()) {
+      return beta_.Target();
+    }
     return {v_[0].transpose(), Eigen::Map<const Eigen::VectorXcd>{
-                                   &log_val_accumulator_.LogVal(), 1}};
+                                   &log_val_accumulators_[0].LogVal(), 1}};
   }
 
-  NETKET_SAMPLER_SET_VISIBLE_DEFAULT(v_[0])
+  NETKET_SAMPLER_SET_VISIBLE_DEFAULT_PT(v_, beta_)
   NETKET_SAMPLER_ACCEPTANCE_DEFAULT_PT(accept_, moves_)
+  NETKET_SAMPLER_STATE_DEFAULT_PT(v_, accept_, moves_, beta_)
+
+  TemperatureLadder& Ladder() noexcept { return beta_; }
+  const TemperatureLadder& Ladder() const noexcept { return beta_; }
+
+  /// \brief Spreads one temperature ladder over all MPI processes.
+  ///
+  /// See TemperatureLadder::SetDistributed(). Must be called by all
+  /// processes.
+  void SetDistributed(bool distributed) {
+    beta_.SetDistributed(distributed);
+    Reset(false);
+  }
 
   Index BatchSize() const noexcept override { return 1; }
+
+  bool SharesChains() const noexcept override { return beta_.IsDistributed(); }
 };
 
 }  // namespace netket
@@ -13,60 +13,21 @@
 // limitations under the License.
 
 #include "Sampler/metropolis_local_v2.hpp"
+#include "Utils/memory_utils.hpp"
 #include "Utils/mpi_interface.hpp"
 
 namespace netket {
 
 namespace detail {
-void Flipper::RandomState() {
-  std::generate(state_.data(), state_.data() + state_.size(), [this]() {
-    return local_states_[std::uniform_int_distribution<int>{
-        0, static_cast<int>(local_states_.size()) - 1}(engine_)];
-  });
-}
-
-void Flipper::RandomSites() {
-  std::generate(sites_.data(), sites_.data() + sites_.size(), [this]() {
-    return std::uniform_int_distribution<Index>{0, Nvisible() - 1}(engine_);
-  });
-}
-
-void Flipper::RandomNewValues() {
-  // `g` proposes new value for spin `sites_(j)` in Markov chain `j`. There
-  // are `local_states_.size() - 1` possible values (minus one is because we
-  // don't want to stay in the same state). Thus first, we generate a random
-  // number in `[0, local_states_.size() - 2]`. Next step is to transform the
-  // result to avoid the gap. Here's an example:
-  //
-  // ```
-  //    indices         0 1 2 3
-  //                   +-+-+-+-+
-  //    local_states_  | | |X| |
-  //                   +-+-+-+-+
-  //    transformed
-  //      indices       0 1   2
-  //
-  // ```
-  // `X` denotes the current state. We see that transformed index is equal to
-  // the original one for all positions before `X`. After `X` however, we need
-  // to increment indices by 1.
-  const auto g = [this](const int j) {
-    const auto idx = std::uniform_int_distribution<int>{
-        0, static_cast<int>(local_states_.size()) - 2}(engine_);
-    return local_states_[idx + (local_states_[idx] >= state_(j, sites_(j)))];
-  };
-  for (auto j = Index{0}; j < BatchSize(); ++j) {
-    new_values_(j) = g(j);
-  }
-}
-
-Flipper::Flipper(std::pair<Index, Index> const shape,
-                 std::vector<double> local_states,
-                 default_random_engine& engine)
+Proposer::Proposer(std::pair<Index, Index> const shape,
+                   Index const cluster_size, const AbstractHilbert& hilbert,
+                   default_random_engine& engine)
     : sites_{},
       new_values_{},
       state_{},
-      local_states_{std::move(local_states)},
+      local_states_{hilbert.LocalStates()},
+      proposal_ratios_{},
+      hilbert_{hilbert},
       proposed_{},
       engine_{engine} {
   Index batch_size, system_size;
@@ -81,58 +42,143 @@ Flipper::Flipper(std::pair<Index, Index> const shape,
     msg << "invalid system size: " << system_size << "; expected >=1";
     throw InvalidInputError{msg.str()};
   }
+  if (cluster_size < 1 || cluster_size > system_size) {
+    std::ostringstream msg;
+    msg << "invalid cluster size: " << cluster_size
+        << "; expected a number in [1, " << system_size << "]";
+    throw InvalidInputError{msg.str()};
+  }
   if (local_states_.empty()) {
     throw InvalidInputError{"invalid local states: []"};
   }
 
-  // #RandomValues() relies on the fact that locat_states_ are sorted.
+  // Derived classes may rely on the fact that local_states_ are sorted.
   std::sort(local_states_.begin(), local_states_.end());
 
-  sites_.resize(batch_size);
-  new_values_.resize(batch_size);
+  sites_.resize(batch_size, cluster_size);
+  new_values_.resize(batch_size, cluster_size);
   state_.resize(batch_size, system_size);
+  proposal_ratios_ = Eigen::ArrayXd::Ones(batch_size);
   proposed_.resize(batch_size);
   for (auto j = Index{0}; j < BatchSize(); ++j) {
-    proposed_[j].values = {&new_values_(j), 1};
-    proposed_[j].sites = {&sites_(j), 1};
+    MoveSize(j, cluster_size);
   }
-  Reset();
 }
 
-void Flipper::Reset() { RandomState(); }
+void Proposer::MoveSize(Index const j, Index const size) noexcept {
+  assert(size >= 0 && size <= ClusterSize());
+  proposed_[j].values = {&new_values_(j, 0), size};
+  proposed_[j].sites = {&sites_(j, 0), size};
+}
 
-void Flipper::Update(nonstd::span<const bool> accept) {
+void Proposer::RandomState() {
+  Eigen::VectorXd v(Nvisible());
+  for (auto j = Index{0}; j < BatchSize(); ++j) {
+    hilbert_.RandomVals(v, engine_);
+    state_.row(j) = v.transpose();
+  }
+}
+
+void Proposer::Reset() { RandomState(); }
+
+void Proposer::Update(nonstd::span<const bool> accept) {
   for (auto j = Index{0}; j < BatchSize(); ++j) {
     if (accept[j]) {
-      state_(j, sites_(j)) = new_values_(j);
+      for (auto k = Index{0}; k < proposed_[j].sites.size(); ++k) {
+        state_(j, sites_(j, k)) = new_values_(j, k);
+      }
     }
   }
 }
 
-nonstd::span<ConfDiff const> Flipper::Propose() {
+void Proposer::Update(nonstd::span<const bool> accept,
+                      Eigen::Ref<RowMatrix<double>> x) {
+  assert(x.rows() == BatchSize() && x.cols() == Nvisible());
+  for (auto j = Index{0}; j < BatchSize(); ++j) {
+    for (auto k = Index{0}; k < proposed_[j].sites.size(); ++k) {
+      if (accept[j]) {
+        state_(j, sites_(j, k)) = new_values_(j, k);
+      } else {
+        x(j, sites_(j, k)) = state_(j, sites_(j, k));
+      }
+    }
+  }
+}
+
+nonstd::span<ConfDiff const> Proposer::Propose() {
   using span = nonstd::span<ConfDiff const>;
-  RandomSites();
-  RandomNewValues();
+  Draw();
   return span{proposed_.data(),
               static_cast<span::index_type>(proposed_.size())};
 }
 
-const RowMatrix<double>& Flipper::Visible() const noexcept { return state_; }
-
-RowMatrix<double>& Flipper::Visible() noexcept { return state_; }
+void Proposer::Propose(Eigen::Ref<RowMatrix<double>> x) {
+  assert(x.rows() == BatchSize() && x.cols() == Nvisible());
+  assert(x == state_);
+  Draw();
+  for (auto j = Index{0}; j < BatchSize(); ++j) {
+    for (auto k = Index{0}; k < proposed_[j].sites.size(); ++k) {
+      x(j, sites_(j, k)) = new_values_(j, k);
+    }
+  }
+}
 
-nonstd::span<const double> Flipper::LocalStates() const noexcept {
+nonstd::span<const double> Proposer::LocalStates() const noexcept {
   return local_states_;
 }
 
-void Flipper::Propose(Eigen::Ref<RowMatrix<double>> x) {
-  assert(x.rows() == BatchSize() && x.cols() == Nvisible());
-  x = state_;
-  const auto updates = Propose();
+Flipper::Flipper(std::pair<Index, Index> const shape,
+                 const AbstractHilbert& hilbert,
+                 default_random_engine& engine)
+    : Proposer{shape, 1, hilbert, engine} {
+  Reset();
+}
+
+void Flipper::RandomState() {
+  std::generate(state_.data(), state_.data() + state_.size(), [this]() {
+    return local_states_[std::uniform_int_distribution<int>{
+        0, static_cast<int>(local_states_.size()) - 1}(engine_)];
+  });
+}
+
+void Flipper::Draw() {
+  RandomSites();
+  RandomNewValues();
+}
+
+void Flipper::RandomSites() {
+  std::generate(sites_.data(), sites_.data() + sites_.size(), [this]() {
+    return std::uniform_int_distribution<Index>{0, Nvisible() - 1}(engine_);
+  });
+}
+
+void Flipper::RandomNewValues() {
+  // `g` proposes new value for spin `sites_(j)` in Markov chain `j`. There
+  // are `local_states_.size() - 1` possible values (minus one is because we
+  // don't want to stay in the same state). Thus first, we generate a random
+  // number in `[0, local_states_.size() - 2]`. Next step is to transform the
+  // result to avoid the gap. Here's an example:
+  //
+  // ```
+  //    indices         0 1 2 3
+  //                   +-+-+-+-+
+  //    local_states_  | | |X| |
+  //                   +-+-+-+-+
+  //    transformed
+  //      indices       0 1   2
+  //
+  // ```
+  // `X` denotes the current state. We see that transformed index is equal to
+  // the original one for all positions before `X`. After `X` however, we need
+  // to increment indices by 1.
+  const auto g = [this](const int j) {
+    const auto idx = std::uniform_int_distribution<int>{
+        0, static_cast<int>(local_states_.size()) - 2}(engine_);
+    return local_states_[idx +
+                         (local_states_[idx] >= state_(j, sites_(j, 0)))];
+  };
   for (auto j = Index{0}; j < BatchSize(); ++j) {
-    const auto& suggestion = updates[j];
-    assert(suggestion.sites.size() == 1 && suggestion.values.size() == 1);
-    x(j, suggestion.sites[0]) = suggestion.values[0];
+    new_values_(j, 0) = g(j);
   }
 }
 
@@ -158,50 +204,55 @@ Index CheckSweepSize(const char* func, const Index sweep_size) {
 
 }  // namespace detail
 
-MetropolisLocalV2::MetropolisLocalV2(AbstractMachine& machine,
-                                     const Index batch_size,
-                                     const Index sweep_size,
-                                     std::true_type /*safe*/)
+MetropolisV2::MetropolisV2(AbstractMachine& machine, const Index batch_size,
+                           const Index sweep_size, const bool use_lookup)
     : AbstractSampler{machine},
-      flipper_{{batch_size, machine.Nvisible()},
-               machine.GetHilbert().LocalStates(),
-               GetRandomEngine()},
-      proposed_X_(batch_size, machine.Nvisible()),
+      proposer_{},
+      proposed_X_(detail::CheckBatchSize(__FUNCTION__, batch_size),
+                  machine.Nvisible()),
       proposed_Y_(batch_size),
       current_Y_(batch_size),
       quotient_Y_(batch_size),
       probability_(batch_size),
+      uniform_(batch_size),
       accept_(batch_size),
-      sweep_size_(sweep_size) {
-  GetMachine().LogVal(flipper_.Visible(), current_Y_, {});
-}
+      sweep_size_(detail::CheckSweepSize(__FUNCTION__, sweep_size)),
+      use_lookup_(use_lookup),
+      lookup_{},
+      log_val_diff_(batch_size),
+      tochange_(static_cast<std::size_t>(batch_size)),
+      newconf_(static_cast<std::size_t>(batch_size)) {}
 
-MetropolisLocalV2::MetropolisLocalV2(AbstractMachine& machine,
-                                     const Index batch_size,
-                                     const Index sweep_size)
-    : MetropolisLocalV2{machine,
-                        detail::CheckBatchSize(__FUNCTION__, batch_size),
-                        detail::CheckSweepSize(__FUNCTION__, sweep_size),
-                        {}} {}
+void MetropolisV2::Init(std::unique_ptr<detail::Proposer> proposer) {
+  assert(proposer != nullptr && proposer_ == nullptr);
+  assert(proposer->BatchSize() == BatchSize() &&
+         proposer->Nvisible() == Nvisible());
+  proposer_ = std::move(proposer);
+  proposed_X_ = proposer_->Visible();
+  GetMachine().LogVal(proposer_->Visible(), current_Y_, {});
+}
 
-void MetropolisLocalV2::Reset(bool init_random) {
+void MetropolisV2::Reset(bool init_random) {
   if (init_random) {
-    flipper_.Reset();
-    GetMachine().LogVal(flipper_.Visible(), current_Y_, {});
+    proposer_->Reset();
+    proposed_X_ = proposer_->Visible();
   }
+  // The parameters of the machine may have changed, so the log-values of the
+  // current configurations are recomputed in both cases
+  GetMachine().LogVal(proposer_->Visible(), current_Y_, {});
 }
 
 std::pair<Eigen::Ref<const RowMatrix<double>>,
           Eigen::Ref<const Eigen::VectorXcd>>
-MetropolisLocalV2::CurrentState() const {
-  return {flipper_.Visible(), current_Y_};
+MetropolisV2::CurrentState() const {
+  return {proposer_->Visible(), current_Y_};
 }
 
-void MetropolisLocalV2::SetVisible(Eigen::Ref<const RowMatrix<double>> x) {
-  auto& visible = flipper_.Visible();
+void MetropolisV2::SetVisible(Eigen::Ref<const RowMatrix<double>> x) {
+  auto& visible = proposer_->Visible();
   CheckShape(__FUNCTION__, "v", {x.rows(), x.cols()},
              {visible.rows(), visible.cols()});
-  const auto local_states = flipper_.LocalStates();
+  const auto local_states = proposer_->LocalStates();
   const auto is_valid = [local_states](const double value) {
     return std::find(local_states.begin(), local_states.end(), value) !=
            local_states.end();
@@ -209,35 +260,100 @@ void MetropolisLocalV2::SetVisible(Eigen::Ref<const RowMatrix<double>> x) {
   NETKET_CHECK(std::all_of(x.data(), x.data() + x.size(), std::cref(is_valid)),
                InvalidInputError, "Invalid visible state");
   visible = x;
+  proposed_X_ = visible;
+  GetMachine().LogVal(visible, current_Y_, {});
+}
+
+void MetropolisV2::SaveChains(std::ostream& stream) const {
+  WriteBinary(stream, proposer_->Visible());
 }
 
-void MetropolisLocalV2::SweepSize(Index const sweep_size) {
+void MetropolisV2::LoadChains(std::istream& stream) {
+  RowMatrix<double> visible(BatchSize(), Nvisible());
+  ReadBinary(stream, visible);
+  SetVisible(visible);
+}
+
+void MetropolisV2::SweepSize(Index const sweep_size) {
   detail::CheckSweepSize(__FUNCTION__, sweep_size);
   sweep_size_ = sweep_size;
 }
 
-void MetropolisLocalV2::Next() {
-  flipper_.Propose(proposed_X_);  // Now proposed_X_ contains next states `v'`
-  GetMachine().LogVal(proposed_X_, /*out=*/proposed_Y_, /*cache=*/{});
+void MetropolisV2::ProposeWithLookup() {
+  const auto updates = proposer_->Propose();
+  for (auto j = Index{0}; j < BatchSize(); ++j) {
+    const auto& suggestion = updates[j];
+    const auto k = static_cast<std::size_t>(j);
+    tochange_[k].assign(suggestion.sites.begin(), suggestion.sites.end());
+    newconf_[k].assign(suggestion.values.begin(), suggestion.values.end());
+  }
+  GetMachine().LogValDiffBatch(proposer_->Visible(), tochange_, newconf_,
+                               lookup_, log_val_diff_);
+  proposed_Y_ = current_Y_ + log_val_diff_.array();
+}
+
+void MetropolisV2::Accept() {
+  auto& engine = GetRandomEngine();
+  std::uniform_real_distribution<double> distribution;
+  std::generate(uniform_.data(), uniform_.data() + uniform_.size(),
+                [&engine, &distribution]() { return distribution(engine); });
   // Calculates acceptance probability
-  quotient_Y_ = (proposed_Y_ - current_Y_).exp();
-  GetMachineFunc()(quotient_Y_, probability_);
-  for (auto i = Index{0}; i < accept_.size(); ++i) {
-    accept_(i) = probability_(i) >= 1.0
-                     ? true
-                     : std::uniform_real_distribution<double>{}(
-                           GetRandomEngine()) < probability_(i);
+  if (HasDefaultMachineFunc()) {
+    // |ψ(v')/ψ(v)|² = exp(2 Re[log ψ(v') - log ψ(v)])
+    probability_ = (2.0 * (proposed_Y_ - current_Y_).real()).exp();
+  } else {
+    quotient_Y_ = (proposed_Y_ - current_Y_).exp();
+    GetMachineFunc()(quotient_Y_, probability_);
   }
-  // Updates current state
-  current_Y_ = accept_.select(proposed_Y_, current_Y_);
-  flipper_.Update({accept_});
+  probability_ *= proposer_->ProposalRatios();
+  accept_ = uniform_ < probability_;
 }
 
-void MetropolisLocalV2::Sweep() {
+void MetropolisV2::Next() {
+  if (use_lookup_) {
+    ProposeWithLookup();
+    Accept();
+    // Only accepted moves change the look-up tables
+    for (auto j = Index{0}; j < BatchSize(); ++j) {
+      if (!accept_(j)) {
+        tochange_[static_cast<std::size_t>(j)].clear();
+        newconf_[static_cast<std::size_t>(j)].clear();
+      }
+    }
+    GetMachine().UpdateLookupBatch(proposer_->Visible(), tochange_, newconf_,
+                                   lookup_);
+    current_Y_ = accept_.select(proposed_Y_, current_Y_);
+    proposer_->Update({accept_});
+  } else {
+    proposer_->Propose(proposed_X_);  // Now proposed_X_ contains `v'`
+    GetMachine().LogVal(proposed_X_, /*out=*/proposed_Y_, /*cache=*/{});
+    Accept();
+    current_Y_ = accept_.select(proposed_Y_, current_Y_);
+    proposer_->Update({accept_}, proposed_X_);
+  }
+}
+
+void MetropolisV2::Sweep() {
   assert(sweep_size_ > 0);
+  if (use_lookup_) {
+    lookup_ = GetMachine().InitLookupBatch(proposer_->Visible());
+  }
   for (auto i = Index{0}; i < sweep_size_; ++i) {
     Next();
   }
+  if (use_lookup_) {
+    // Removes the round-off accumulated by summing log-value differences
+    GetMachine().LogVal(proposer_->Visible(), current_Y_, {});
+  }
+}
+
+MetropolisLocalV2::MetropolisLocalV2(AbstractMachine& machine,
+                                     const Index batch_size,
+                                     const Index sweep_size,
+                                     const bool use_lookup)
+    : MetropolisV2{machine, batch_size, sweep_size, use_lookup} {
+  Init(make_unique<detail::Flipper>(std::make_pair(batch_size, Nvisible()),
+                                    machine.GetHilbert(), GetRandomEngine()));
 }
 
 }  // namespace netket
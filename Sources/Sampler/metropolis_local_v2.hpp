@@ -17,6 +17,7 @@
 
 #include <functional>
 #include <limits>
+#include <memory>
 #include <vector>
 
 #include <Eigen/Core>
@@ -35,115 +36,200 @@ struct ConfDiff {
 };
 
 namespace detail {
-/// Suggests which spins to try flipping next.
-class Flipper {
+/// \brief Suggests moves for a batch of Markov chains.
+///
+/// Every move changes the quantum numbers at (at most) #ClusterSize() sites.
+/// Derived classes decide which sites and which new values are proposed.
+class Proposer {
  public:
-  template <class T>
-  using Vector = Eigen::Matrix<T, Eigen::Dynamic, 1>;
+  Proposer(std::pair<Index, Index> shape, Index cluster_size,
+           const AbstractHilbert& hilbert, default_random_engine& engine);
 
-  inline Flipper(std::pair<Index, Index> const shape,
-                 std::vector<double> local_states,
-                 default_random_engine& engine);
+  Proposer(const Proposer&) = delete;
+  Proposer& operator=(const Proposer&) = delete;
+  virtual ~Proposer() = default;
 
   Index BatchSize() const noexcept { return state_.rows(); }
   Index Nvisible() const noexcept { return state_.cols(); }
+  Index ClusterSize() const noexcept { return sites_.cols(); }
 
-  /// \brief Resets the flipper.
+  /// \brief Resets the proposer.
   ///
   /// Randomizes internal state.
-  inline void Reset();
+  void Reset();
 
   /// \brief Makes a move.
   ///
-  /// \param accept has length #BatchSize() and describes which flips were
-  /// accepted and which weren't (`accept[i]==true` means that the `i`th flip
+  /// \param accept has length #BatchSize() and describes which moves were
+  /// accepted and which weren't (`accept[i]==true` means that the `i`th move
   /// was accepted).
-  inline void Update(nonstd::span<const bool> accept);
+  void Update(nonstd::span<const bool> accept);
+
+  /// \brief Same as above, but also reverts the rejected moves in \p x.
+  ///
+  /// \param x the matrix previously passed to #Propose(). Afterwards it is
+  /// again equal to #Visible().
+  void Update(nonstd::span<const bool> accept,
+              Eigen::Ref<RowMatrix<double>> x);
 
   /// \brief Returns the current visible state.
   ///
   /// Each row of the matrix describes one visible configuration. There are
   /// #BatchSize() rows in the returned matrix.
-  inline const RowMatrix<double>& Visible() const noexcept;
+  const RowMatrix<double>& Visible() const noexcept { return state_; }
 
   /// \brief Returns the current visible state.
   ///
   /// Each row of the matrix describes one visible configuration. There are
   /// #BatchSize() rows in the returned matrix.
-  inline RowMatrix<double>& Visible() noexcept;
+  RowMatrix<double>& Visible() noexcept { return state_; }
 
-  /// \brief Returns next spins to try flipping.
+  /// \brief Returns the next moves to try.
   ///
   /// \warning Don't call this function more than once per call to #Update()!
-  inline nonstd::span<ConfDiff const> Propose();
+  nonstd::span<ConfDiff const> Propose();
 
-  /// \brief Similar to #Read() except that the result is written into \p x.
+  /// \brief Similar to #Propose() except that the proposed moves are applied
+  /// to \p x.
+  ///
+  /// \p x must be equal to #Visible(): only the proposed sites are written,
+  /// which avoids copying the whole state on every step.
   ///
   /// \warning Don't call this function more than once per call to #Update()!
-  inline void Propose(Eigen::Ref<RowMatrix<double>> x);
+  void Propose(Eigen::Ref<RowMatrix<double>> x);
 
-  inline nonstd::span<const double> LocalStates() const noexcept;
+  nonstd::span<const double> LocalStates() const noexcept;
 
- private:
-  /// \brief Randomizes the state.
+  /// \brief Returns the ratios `T(x' → x) / T(x → x')` of the probabilities
+  /// to propose the reverse and the last proposed moves.
   ///
-  /// New state is sampled uniformly from #local_states_
-  inline void RandomState();
+  /// They enter the acceptance probability and are all equal to one for
+  /// symmetric proposals, which is the default.
+  const Eigen::ArrayXd& ProposalRatios() const noexcept {
+    return proposal_ratios_;
+  }
 
-  /// \brief Randomizes the indices.
+ protected:
+  /// \brief Fills #sites_ and #new_values_ with the next moves.
+  virtual void Draw() = 0;
+
+  /// \brief Randomizes the state.
   ///
-  /// New indices are sampled uniformly.
-  inline void RandomSites();
+  /// The default implementation uses the Hilbert space, so that constraints
+  /// such as a fixed magnetization are respected.
+  virtual void RandomState();
 
-  /// \brief Randomizes the values.
+  /// \brief Sets the number of sites changed by the move of the \p j'th
+  /// Markov chain.
   ///
-  /// New values are chosen uniformly from all possible quantum numbers except
-  /// the current one (to minimize staying in the same configuration).
-  inline void RandomNewValues();
-
-  /// \brief A vector of size `BatchSize()` which indices of sites at which we
-  /// suggest changing quantum numbers
-  Vector<Index> sites_;
-  /// \brief A vector of size `BatchSize()` which contains new (proposed)
-  /// quantum numbers.
-  Vector<double> new_values_;
+  /// Only the first \p size columns of the \p j'th rows of #sites_ and
+  /// #new_values_ are then used. By default all moves have #ClusterSize()
+  /// sites.
+  void MoveSize(Index j, Index size) noexcept;
+
+  /// \brief A matrix of size `BatchSize() x ClusterSize()` with the indices
+  /// of sites at which we suggest changing quantum numbers.
+  RowMatrix<Index> sites_;
+  /// \brief A matrix of size `BatchSize() x ClusterSize()` which contains new
+  /// (proposed) quantum numbers.
+  RowMatrix<double> new_values_;
   /// \brief A matrix of size `BatchSize() x Nvisible()` with the
   /// current state of #BatchSize() different Markov chains.
   RowMatrix<double> state_;
-  /// \brief Allowed values for quantum numbers
+  /// \brief Allowed values for quantum numbers (sorted)
   std::vector<double> local_states_;
+  /// \brief Ratios of the proposal probabilities, see #ProposalRatios().
+  /// Proposers with asymmetric moves must fill them in #Draw().
+  Eigen::ArrayXd proposal_ratios_;
 
+  const AbstractHilbert& hilbert_;
   std::vector<ConfDiff> proposed_;
   default_random_engine& engine_;
 };
+
+/// Suggests which spins to try flipping next.
+class Flipper : public Proposer {
+ public:
+  Flipper(std::pair<Index, Index> shape, const AbstractHilbert& hilbert,
+          default_random_engine& engine);
+
+ protected:
+  void Draw() override;
+
+  /// \brief Randomizes the state.
+  ///
+  /// New state is sampled uniformly from #local_states_
+  void RandomState() override;
+
+ private:
+  /// \brief Randomizes the indices.
+  ///
+  /// New indices are sampled uniformly.
+  void RandomSites();
+
+  /// \brief Randomizes the values.
+  ///
+  /// New values are chosen uniformly from all possible quantum numbers except
+  /// the current one (to minimize staying in the same configuration).
+  void RandomNewValues();
+};
 }  // namespace detail
 
-class MetropolisLocalV2 : public AbstractSampler {
-  detail::Flipper flipper_;
+/// \brief Metropolis sampling of #BatchSize() Markov chains at once.
+///
+/// Moves are suggested by a detail::Proposer, and all the proposals of a step
+/// are evaluated with one batched call to the machine.
+class MetropolisV2 : public AbstractSampler {
+  std::unique_ptr<detail::Proposer> proposer_;
   RowMatrix<double> proposed_X_;
   Eigen::ArrayXcd proposed_Y_;
   Eigen::ArrayXcd current_Y_;
   Eigen::ArrayXcd quotient_Y_;
   Eigen::ArrayXd probability_;
+  Eigen::ArrayXd uniform_;
   Eigen::Array<bool, Eigen::Dynamic, 1> accept_;
   Index sweep_size_;
 
-  inline MetropolisLocalV2(AbstractMachine& machine, Index batch_size,
-                           Index sweep_size, std::true_type);
+  /// Whether proposals are evaluated with the machine's batched look-up
+  /// tables (see AbstractMachine::InitLookupBatch) instead of LogVal.
+  bool use_lookup_;
+  any lookup_;
+  Eigen::VectorXcd log_val_diff_;
+  std::vector<std::vector<int>> tochange_;
+  std::vector<std::vector<double>> newconf_;
 
   /// Makes a step.
   void Next();
 
- public:
-  MetropolisLocalV2(AbstractMachine& machine, Index batch_size,
-                    Index sweep_size);
+  /// Computes #proposed_Y_ using the look-up tables.
+  void ProposeWithLookup();
+
+  /// Decides which proposals to accept, filling #accept_.
+  void Accept();
 
-  Index BatchSize() const noexcept override { return flipper_.BatchSize(); }
-  Index Nvisible() const noexcept { return flipper_.Nvisible(); }
+ protected:
+  void SaveChains(std::ostream& stream) const override;
+  void LoadChains(std::istream& stream) override;
+
+  MetropolisV2(AbstractMachine& machine, Index batch_size, Index sweep_size,
+               bool use_lookup);
+
+  /// \brief Installs the proposer and initializes the Markov chains.
+  ///
+  /// Must be called exactly once from the constructor of derived classes
+  /// (the proposer needs the random engine which is only available after
+  /// AbstractSampler has been constructed).
+  void Init(std::unique_ptr<detail::Proposer> proposer);
+
+ public:
+  Index BatchSize() const noexcept override { return proposed_X_.rows(); }
+  Index Nvisible() const noexcept { return proposed_X_.cols(); }
 
   Index SweepSize() const noexcept { return sweep_size_; }
   void SweepSize(Index sweep_size);
 
+  bool UsesLookup() const noexcept { return use_lookup_; }
+
   /// Returns a batch of current visible states and corresponding log values.
   std::pair<Eigen::Ref<const RowMatrix<double>>,
             Eigen::Ref<const Eigen::VectorXcd>>
@@ -153,10 +239,20 @@ class MetropolisLocalV2 : public AbstractSampler {
 
   void Sweep() override;
 
-  /// Resets the sampler.
+  /// \brief Resets the sampler.
+  ///
+  /// The Markov chains keep their configurations unless \p init_random is
+  /// `true`, but their log-values are always recomputed.
   void Reset(bool init_random) override;
 };
 
+/// Metropolis sampling with single-site moves.
+class MetropolisLocalV2 : public MetropolisV2 {
+ public:
+  MetropolisLocalV2(AbstractMachine& machine, Index batch_size,
+                    Index sweep_size, bool use_lookup = false);
+};
+
 }  // namespace netket
 
 #endif  // SOURCES_SAMPLER_METROPOLIS_LOCAL_V2_HPP
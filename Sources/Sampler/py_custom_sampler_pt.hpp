@@ -69,6 +69,7 @@ void AddCustomSamplerPt(py::module subm) {
                         &CustomSamplerPt::SetSweepSize, R"EOF(
                              The size of the sweep. Extra caution should be put in making sure that the number of sweeps is sufficient to have an ergodic sampling.)EOF");
   AddAcceptance(cls);
+  AddTemperatureLadder(cls);
 }
 }  // namespace netket
 #endif
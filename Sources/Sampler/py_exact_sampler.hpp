@@ -32,8 +32,8 @@ void AddExactSampler(py::module &subm) {
     for large systems, where Metropolis-based sampling are instead a viable
     option.
     )EOF")
-          .def(py::init<AbstractMachine &>(), py::keep_alive<1, 2>(),
-               py::arg("machine"), R"EOF(
+          .def(py::init<AbstractMachine &, Index>(), py::keep_alive<1, 2>(),
+               py::arg("machine"), py::arg("batch_size") = 1, R"EOF(
              Constructs a new ``ExactSampler`` given a machine.
 
              Args:
@@ -41,6 +41,8 @@ void AddExactSampler(py::module &subm) {
                           The probability distribution being sampled
                           from is $$F(\Psi(s))$$, where the function
                           $$F(X)$$, is arbitrary, by default $$F(X)=|X|^2$$.
+                 batch_size: The number of independent samples drawn at
+                          every sweep.
 
              Examples:
                  Exact sampling from a RBM machine in a 1D lattice of spin 1/2
@@ -67,6 +67,7 @@ void AddMetropolisExchangePt(py::module &subm) {
                  ```
              )EOF");
   AddAcceptance(cls);
+  AddTemperatureLadder(cls);
 }
 
 }  // namespace netket
@@ -68,6 +68,7 @@ void AddMetropolisHamiltonianPt(py::module &subm) {
                  ```
              )EOF");
   AddAcceptance(cls);
+  AddTemperatureLadder(cls);
 }
 }  // namespace netket
 #endif
@@ -62,6 +62,7 @@ void AddMetropolisLocalPt(py::module &subm) {
                  ```
              )EOF");
   AddAcceptance(cls);
+  AddTemperatureLadder(cls);
 }
 }  // namespace netket
 #endif
@@ -27,6 +27,9 @@
 #include "Graph/graph.hpp"
 #include "Operator/operator.hpp"
 #include "Sampler/abstract_sampler.hpp"
+#include "Sampler/custom_sampler_v2.hpp"
+#include "Sampler/metropolis_cluster_v2.hpp"
+#include "Sampler/metropolis_exchange_v2.hpp"
 #include "Sampler/metropolis_local_v2.hpp"
 #include "Utils/memory_utils.hpp"
 #include "Utils/parallel_utils.hpp"
@@ -40,6 +43,38 @@ pybind11::class_<T, Args...> AddAcceptance(pybind11::class_<T, Args...> cls) {
         numpy.array: The measured acceptance rate for the sampling.
         In the case of rejection-free sampling this is always equal to 1.)EOF");
 }
+
+template <class T, class... Args>
+pybind11::class_<T, Args...> AddTemperatureLadder(
+    pybind11::class_<T, Args...> cls) {
+  return cls
+      .def_property_readonly(
+          "betas", [](const T& self) { return self.Ladder().Betas(); },
+          R"EOF(list[float]: Inverse temperatures of the replicas. The first
+                replica samples the target distribution.)EOF")
+      .def_property(
+          "adaptive_sweeps",
+          [](const T& self) { return self.Ladder().AdaptiveSweeps(); },
+          [](T& self, int sweeps) { self.Ladder().SetAdaptiveSweeps(sweeps); },
+          R"EOF(int: Number of remaining sweeps during which the inverse
+                temperatures are adapted. Setting it to `n` adjusts the
+                ladder during the next `n` sweeps towards equal exchange
+                acceptance for all pairs of neighbouring replicas. Afterwards
+                the ladder is frozen. Use it during thermalization only,
+                since samples taken while the ladder changes are biased.)EOF")
+      .def_property(
+          "distributed",
+          [](const T& self) { return self.Ladder().IsDistributed(); },
+          &T::SetDistributed,
+          R"EOF(bool: Whether one temperature ladder is spread over all MPI
+                processes. Each process then holds `n_replicas` replicas of
+                a ladder with `n_replicas * n_processes` temperatures, and
+                replicas exchange temperatures instead of configurations.
+                All processes return the configuration at the physical
+                temperature, i.e. they sample the same Markov chain (see
+                `shares_chains`). Setting it resets the ladder and must be
+                done on all processes, like setting `visible` afterwards.)EOF");
+}
 }  // namespace netket
 
 #include "py_custom_sampler.hpp"
@@ -60,12 +95,14 @@ namespace netket {
 void AddMetropolisLocalV2(py::module m) {
   py::class_<MetropolisLocalV2, AbstractSampler>(m, "MetropolisLocalV2")
       .def(py::init([](AbstractMachine& machine, Index batch_size,
-                       nonstd::optional<Index> sweep_size) {
+                       nonstd::optional<Index> sweep_size, bool use_lookup) {
              return make_unique<MetropolisLocalV2>(
-                 machine, batch_size, sweep_size.value_or(machine.Nvisible()));
+                 machine, batch_size, sweep_size.value_or(machine.Nvisible()),
+                 use_lookup);
            }),
            py::keep_alive<1, 2>{}, py::arg{"machine"},
            py::arg{"batch_size"} = 16, py::arg{"sweep_size"} = py::none(),
+           py::arg{"use_lookup"} = false,
            R"EOF(See `MetropolisLocal` for information about the algorithm.
 
                  `MetropolisLocalV2` differs from `MetropolisLocal` in that it
@@ -73,7 +110,146 @@ void AddMetropolisLocalV2(py::module m) {
                  Generating `batch_size` new samples requires only one call to
                  `Machine.log_val` which helps to hide the latency associated
                  with the call.
-           )EOF");
+
+                 If `use_lookup` is `True`, proposals are instead evaluated
+                 incrementally using look-up tables of all the chains. This
+                 is much cheaper for machines with fast updates, such as
+                 `RbmSpin`.
+           )EOF")
+      .def_property_readonly("use_lookup", &MetropolisLocalV2::UsesLookup,
+                             R"EOF(bool: Whether look-up tables are used.)EOF");
+}
+
+void AddMetropolisExchangeV2(py::module m) {
+  py::class_<MetropolisExchangeV2, AbstractSampler>(m, "MetropolisExchangeV2")
+      .def(py::init([](AbstractMachine& machine, const AbstractGraph& graph,
+                       int d_max, Index batch_size,
+                       nonstd::optional<Index> sweep_size, bool use_lookup) {
+             return make_unique<MetropolisExchangeV2>(
+                 machine, graph, d_max, batch_size,
+                 sweep_size.value_or(machine.Nvisible()), use_lookup);
+           }),
+           py::keep_alive<1, 2>{}, py::arg{"machine"}, py::arg{"graph"},
+           py::arg{"d_max"} = 1, py::arg{"batch_size"} = 16,
+           py::arg{"sweep_size"} = py::none(), py::arg{"use_lookup"} = false,
+           R"EOF(See `MetropolisExchange` for information about the algorithm.
+
+                 Like `MetropolisLocalV2`, it runs `batch_size` Markov Chains
+                 in parallel on one MPI node, and all proposed exchanges are
+                 evaluated with a single call to `Machine.log_val` (or to the
+                 look-up tables if `use_lookup` is `True`).
+           )EOF")
+      .def_property_readonly("use_lookup", &MetropolisExchangeV2::UsesLookup,
+                             R"EOF(bool: Whether look-up tables are used.)EOF");
+}
+
+void AddMetropolisHopV2(py::module m) {
+  py::class_<MetropolisHopV2, AbstractSampler>(m, "MetropolisHopV2")
+      .def(py::init([](AbstractMachine& machine, int d_max, Index batch_size,
+                       nonstd::optional<Index> sweep_size, bool use_lookup) {
+             return make_unique<MetropolisHopV2>(
+                 machine, machine.GetHilbert().GetGraph(), d_max, batch_size,
+                 sweep_size.value_or(machine.Nvisible()), use_lookup);
+           }),
+           py::keep_alive<1, 2>{}, py::arg{"machine"}, py::arg{"d_max"} = 1,
+           py::arg{"batch_size"} = 16, py::arg{"sweep_size"} = py::none(),
+           py::arg{"use_lookup"} = false,
+           R"EOF(See `MetropolisHop` for information about the algorithm.
+
+                 Like `MetropolisLocalV2`, it runs `batch_size` Markov Chains
+                 in parallel on one MPI node, and all proposed hops are
+                 evaluated with a single call to `Machine.log_val` (or to the
+                 look-up tables if `use_lookup` is `True`).
+           )EOF")
+      .def_property_readonly("use_lookup", &MetropolisHopV2::UsesLookup,
+                             R"EOF(bool: Whether look-up tables are used.)EOF");
+}
+
+void AddMetropolisClusterV2(py::module m) {
+  py::class_<MetropolisClusterV2, AbstractSampler>(m, "MetropolisClusterV2")
+      .def(py::init([](AbstractMachine& machine, double bond_probability,
+                       nonstd::optional<bool> antiferromagnetic,
+                       bool conserve_total, Index batch_size,
+                       nonstd::optional<Index> sweep_size, bool use_lookup) {
+             const auto& graph = machine.GetHilbert().GetGraph();
+             return make_unique<MetropolisClusterV2>(
+                 machine, graph, bond_probability,
+                 antiferromagnetic.value_or(graph.IsBipartite()),
+                 conserve_total, batch_size,
+                 sweep_size.value_or(machine.Nvisible()), use_lookup);
+           }),
+           py::keep_alive<1, 2>{}, py::arg{"machine"},
+           py::arg{"bond_probability"} = 0.5,
+           py::arg{"antiferromagnetic"} = py::none(),
+           py::arg{"conserve_total"} = false, py::arg{"batch_size"} = 16,
+           py::arg{"sweep_size"} = py::none(), py::arg{"use_lookup"} = false,
+           R"EOF(Metropolis sampling with cluster moves, which decorrelate
+                 much faster than local moves close to a phase transition.
+
+                 A cluster is grown from a random site along the edges of the
+                 graph of the Hilbert space: a neighbour is added with
+                 probability `bond_probability` if its bond is satisfied,
+                 i.e. if both sites hold the same quantum number or, for
+                 `antiferromagnetic` clusters, different ones. The whole
+                 cluster is then flipped. The acceptance probability accounts
+                 for the different probabilities to grow the cluster before
+                 and after the flip, so any `bond_probability` in [0, 1)
+                 samples the correct distribution. Only Hilbert spaces with
+                 two local states, such as spin 1/2, are supported.
+
+                 Like `MetropolisLocalV2`, it runs `batch_size` Markov Chains
+                 in parallel on one MPI node, and all proposed flips are
+                 evaluated with a single call to `Machine.log_val` (or to the
+                 look-up tables if `use_lookup` is `True`).
+
+                 Args:
+                     machine: A machine used for the sampling.
+                     bond_probability: Probability to add a site connected by
+                         a satisfied bond to the cluster.
+                     antiferromagnetic: Whether clusters are made of sites
+                         with different quantum numbers. Defaults to whether
+                         the graph is bipartite.
+                     conserve_total: If `True`, clusters which would change
+                         the sum of the quantum numbers are not flipped. It
+                         must be set for Hilbert spaces with a fixed
+                         `total_sz`, and requires antiferromagnetic clusters
+                         and a positive `bond_probability`.
+                     batch_size: Number of Markov chains.
+                     sweep_size: Number of moves per sweep. Defaults to the
+                         number of visible units.
+                     use_lookup: Whether look-up tables are used.
+           )EOF")
+      .def_property_readonly("use_lookup", &MetropolisClusterV2::UsesLookup,
+                             R"EOF(bool: Whether look-up tables are used.)EOF");
+}
+
+void AddCustomSamplerV2(py::module m) {
+  py::class_<CustomSamplerV2, AbstractSampler>(m, "CustomSamplerV2")
+      .def(py::init([](AbstractMachine& machine,
+                       const LocalOperator& move_operators,
+                       const std::vector<double>& move_weights,
+                       Index batch_size, nonstd::optional<Index> sweep_size,
+                       bool use_lookup) {
+             return make_unique<CustomSamplerV2>(
+                 machine, move_operators, move_weights, batch_size,
+                 sweep_size.value_or(machine.Nvisible()), use_lookup);
+           }),
+           py::keep_alive<1, 2>{}, py::arg{"machine"},
+           py::arg{"move_operators"},
+           py::arg{"move_weights"} = std::vector<double>{},
+           py::arg{"batch_size"} = 16, py::arg{"sweep_size"} = py::none(),
+           py::arg{"use_lookup"} = false,
+           R"EOF(See `CustomSampler` for information about the algorithm.
+
+                 Like `MetropolisLocalV2`, it runs `batch_size` Markov Chains
+                 in parallel on one MPI node, and all proposed moves are
+                 evaluated with a single call to `Machine.log_val` (or to the
+                 look-up tables if `use_lookup` is `True`). The local
+                 matrices of `move_operators` are converted to transition
+                 tables once, at construction.
+           )EOF")
+      .def_property_readonly("use_lookup", &CustomSamplerV2::UsesLookup,
+                             R"EOF(bool: Whether look-up tables are used.)EOF");
 }
 
 void AddSamplerModule(py::module& m) {
@@ -112,10 +288,31 @@ void AddSamplerModule(py::module& m) {
           init_random: If ``True`` the quantum numbers (visible units)
           are initialized at random, otherwise their value is preserved.
       )EOF")
-      .def("sweep", &AbstractSampler::Sweep, R"EOF(
+      .def("sweep", &AbstractSampler::Sweep,
+           py::call_guard<py::gil_scoped_release>(), R"EOF(
       Performs a sampling sweep. Typically a single sweep
       consists of an extensive number of local moves.
       )EOF")
+      .def("save_state", &AbstractSampler::SaveState, py::arg("filename"),
+           R"EOF(
+      Saves the configurations of the Markov chains, the state of the random
+      number generator and the acceptance statistics to a binary file.
+      When running with MPI, every node writes its own file
+      ``filename.<rank>``.
+
+      Args:
+          filename: Name of the file.
+      )EOF")
+      .def("load_state", &AbstractSampler::LoadState, py::arg("filename"),
+           R"EOF(
+      Restores a state written by ``save_state``, so that sampling continues
+      exactly where it stopped. The sampler must have been constructed with
+      the same settings, and the parameters of the machine should be loaded
+      beforehand.
+
+      Args:
+          filename: Name of the file passed to ``save_state``.
+      )EOF")
       .def_property_readonly(
           "visible",
           [](const AbstractSampler& self) { return self.CurrentState().first; },
@@ -125,6 +322,10 @@ void AddSamplerModule(py::module& m) {
         netket.machine: The machine used for the sampling.  )EOF")
       .def_property_readonly("batch_size", &AbstractSampler::BatchSize, R"EOF(
         int: Number of samples in a batch.)EOF")
+      .def_property_readonly("shares_chains", &AbstractSampler::SharesChains,
+                             R"EOF(
+        bool: Whether all MPI processes hold the same Markov chains, whose
+              samples must then be counted only once in statistics.)EOF")
       .def_property(
           "machine_func",
           [](const AbstractSampler& self) {
@@ -148,6 +349,8 @@ void AddSamplerModule(py::module& m) {
           [](AbstractSampler& self, py::function func) {
             self.SetMachineFunc([func](nonstd::span<const Complex> x,
                                        nonstd::span<double> out) {
+              // Sweeps run with the GIL released
+              py::gil_scoped_acquire gil;
               auto input = py::array_t<Complex>{static_cast<size_t>(x.size()),
                                                 x.data(), /*base=*/py::none()};
               py::detail::array_proxy(input.ptr())->flags &=
@@ -173,6 +376,10 @@ void AddSamplerModule(py::module& m) {
   AddCustomSampler(subm);
   AddCustomSamplerPt(subm);
   AddMetropolisLocalV2(subm);
+  AddMetropolisExchangeV2(subm);
+  AddMetropolisHopV2(subm);
+  AddCustomSamplerV2(subm);
+  AddMetropolisClusterV2(subm);
 }
 
 }  // namespace netket
@@ -0,0 +1,375 @@
+// Copyright 2019 The Simons Foundation, Inc. - All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef NETKET_TEMPERATURE_LADDER_HPP
+#define NETKET_TEMPERATURE_LADDER_HPP
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <istream>
+#include <ostream>
+#include <sstream>
+#include <vector>
+
+#include <mpi.h>
+#include <Eigen/Core>
+#include "Sampler/abstract_sampler.hpp"
+#include "Utils/binary_io.hpp"
+#include "Utils/exceptions.hpp"
+#include "Utils/mpi_interface.hpp"
+#include "Utils/random_utils.hpp"
+#include "common_types.hpp"
+
+namespace netket {
+
+/// \brief Inverse temperatures of the replicas of a parallel-tempering
+/// sampler.
+///
+/// The coldest temperature is always `beta = 1` and the hottest one
+/// `beta = 1 / n`, `n` being the number of replicas in the ladder. By default
+/// the ladder in between is linear.
+///
+/// The ladder can be adapted online during a warm-up phase (see
+/// #SetAdaptiveSweeps()). The gaps between neighbouring betas are then
+/// adjusted until the exchange acceptance is the same for all pairs of
+/// neighbouring replicas, after which the ladder is frozen.
+///
+/// In distributed mode (see #SetDistributed()) one ladder is spread over all
+/// MPI processes, each of which holds #LocalSize() replicas. Replicas then
+/// exchange their temperatures rather than their configurations, so only
+/// log-values and the decisions are communicated. The configuration at
+/// `beta = 1` is broadcast to all processes after every sweep and is
+/// returned by #Target(), so all processes sample the same Markov chain (see
+/// AbstractSampler::SharesChains()).
+class TemperatureLadder {
+  /// Inverse temperatures, ordered from the coldest (`beta = 1`) to the
+  /// hottest one.
+  std::vector<double> beta_;
+  /// Index into #beta_ for every replica of the ladder. Replicas are
+  /// numbered process by process, `rank * LocalSize() + r` being the `r`th
+  /// replica of process `rank`. Outside of distributed mode it is the
+  /// identity, since samplers exchange configurations instead.
+  std::vector<int> temperature_;
+  int nlocal_;
+  bool distributed_;
+  int rank_;
+
+  /// Configuration and log-value of the replica at `beta = 1` (only used in
+  /// distributed mode).
+  Eigen::VectorXd target_v_;
+  Complex target_log_val_;
+
+  /// Exchange statistics of the current adaptation window. Element `r - 1`
+  /// corresponds to exchanges between replicas `r - 1` and `r`.
+  Eigen::VectorXd accepts_;
+  Eigen::VectorXd moves_;
+
+  /// Number of remaining sweeps during which the ladder is adapted.
+  int adaptive_sweeps_;
+  /// Number of sweeps recorded in the current window.
+  int window_sweeps_;
+  /// Number of adaptation steps done so far (used for the step size).
+  int steps_;
+
+  /// Number of sweeps over which exchange acceptances are averaged before
+  /// the ladder is updated.
+  static constexpr int kWindow = 10;
+
+ public:
+  explicit TemperatureLadder(int nreplicas = 1)
+      : nlocal_{0}, distributed_{false}, rank_{0}, target_log_val_{0., 0.} {
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank_);
+    Resize(nreplicas);
+  }
+
+  /// \brief Resets the ladder to the linear one with \p nreplicas replicas
+  /// per process.
+  ///
+  /// Distributed mode is left.
+  void Resize(int nreplicas) {
+    if (nreplicas < 1) {
+      std::ostringstream msg;
+      msg << "invalid number of replicas: " << nreplicas << "; expected >=1";
+      throw InvalidInputError{msg.str()};
+    }
+    nlocal_ = nreplicas;
+    SetDistributed(false);
+  }
+
+  /// \brief Enters or leaves distributed mode.
+  ///
+  /// Resets the ladder to the linear one over all replicas of the ladder.
+  /// Must be called by all processes.
+  void SetDistributed(bool distributed) {
+    int nranks = 1;
+    if (distributed) {
+      MPI_Comm_size(MPI_COMM_WORLD, &nranks);
+    }
+    const int size = nlocal_ * nranks;
+    distributed_ = distributed;
+    beta_.resize(size);
+    temperature_.resize(size);
+    for (int i = 0; i < size; i++) {
+      beta_[i] = 1. - double(i) / double(size);
+      temperature_[i] = i;
+    }
+    accepts_ = Eigen::VectorXd::Zero(size - 1);
+    moves_ = Eigen::VectorXd::Zero(size - 1);
+    adaptive_sweeps_ = 0;
+    window_sweeps_ = 0;
+    steps_ = 0;
+  }
+
+  bool IsDistributed() const noexcept { return distributed_; }
+
+  /// Number of replicas held by this process.
+  int LocalSize() const noexcept { return nlocal_; }
+
+  /// Returns the inverse temperature of the local replica \p r.
+  double operator[](int r) const noexcept {
+    return beta_[temperature_[Offset() + r]];
+  }
+
+  const std::vector<double>& Betas() const noexcept { return beta_; }
+
+  /// \brief Adapts the ladder during the next \p sweeps sweeps.
+  ///
+  /// Once they are done the ladder is frozen.
+  void SetAdaptiveSweeps(int sweeps) {
+    if (sweeps < 0) {
+      std::ostringstream msg;
+      msg << "invalid number of adaptive sweeps: " << sweeps
+          << "; expected >=0";
+      throw InvalidInputError{msg.str()};
+    }
+    adaptive_sweeps_ = sweeps;
+    window_sweeps_ = 0;
+    steps_ = 0;
+    accepts_.setZero();
+    moves_.setZero();
+  }
+
+  int AdaptiveSweeps() const noexcept { return adaptive_sweeps_; }
+
+  /// Records an attempted exchange between temperatures `r - 1` and `r`.
+  void Record(int r, bool accepted) noexcept {
+    assert(r >= 1 && r < static_cast<int>(beta_.size()));
+    if (adaptive_sweeps_ > 0) {
+      accepts_(r - 1) += accepted;
+      moves_(r - 1) += 1;
+    }
+  }
+
+  /// \brief Exchanges temperatures between the replicas of all processes.
+  ///
+  /// Like in the local case, first the pairs of temperatures `(r - 1, r)`
+  /// with odd `r` and then the ones with even `r` attempt an exchange. The
+  /// log-values of all replicas are gathered on the root process which
+  /// decides about the exchanges, and the decisions are broadcast to all
+  /// processes which then replay them.
+  ///
+  /// \param log_vals log-values of the local replicas.
+  /// \param probability computes the acceptance probability of an exchange
+  /// from `exp((beta_r - beta_{r-1}) * (log psi_{r-1} - log psi_r))`.
+  /// \param accepts, moves per-replica statistics of the local replicas.
+  template <class Probability>
+  void ExchangeDistributed(const std::vector<LogValAccumulator>& log_vals,
+                           Probability&& probability,
+                           Eigen::Ref<Eigen::VectorXd> accepts,
+                           Eigen::Ref<Eigen::VectorXd> moves,
+                           default_random_engine& engine) {
+    assert(distributed_);
+    assert(static_cast<int>(log_vals.size()) == nlocal_);
+    const int size = static_cast<int>(beta_.size());
+    std::vector<Complex> local(nlocal_);
+    for (int r = 0; r < nlocal_; r++) {
+      local[r] = log_vals[r].LogVal();
+    }
+    std::vector<Complex> all(rank_ == 0 ? size : 0);
+    MPI_Gather(local.data(), nlocal_, MPI_DOUBLE_COMPLEX, all.data(), nlocal_,
+               MPI_DOUBLE_COMPLEX, 0, MPI_COMM_WORLD);
+
+    // accepted[r - 1] tells whether temperatures `r - 1` and `r` are swapped
+    std::vector<int> accepted(size - 1);
+    if (rank_ == 0) {
+      std::uniform_real_distribution<double> distribution(0, 1);
+      auto temperature = temperature_;
+      ExchangePasses(temperature, [&](int r, int g1, int g2) {
+        accepted[r - 1] =
+            probability(std::exp((beta_[r] - beta_[r - 1]) *
+                                 (all[g2] - all[g1]))) > distribution(engine);
+        return accepted[r - 1] != 0;
+      });
+    }
+    MPI_Bcast(accepted.data(), size - 1, MPI_INT, 0, MPI_COMM_WORLD);
+
+    const int offset = Offset();
+    ExchangePasses(temperature_, [&](int r, int g1, int g2) {
+      for (const int g : {g1, g2}) {
+        if (g >= offset && g < offset + nlocal_) {
+          accepts(g - offset) += accepted[r - 1];
+          moves(g - offset) += 1;
+        }
+      }
+      Record(r, accepted[r - 1] != 0);
+      return accepted[r - 1] != 0;
+    });
+  }
+
+  /// \brief Broadcasts the configuration at `beta = 1` to all processes.
+  ///
+  /// \param v configurations of the local replicas.
+  /// \param log_vals log-values of the local replicas.
+  void SyncTarget(const std::vector<Eigen::VectorXd>& v,
+                  const std::vector<LogValAccumulator>& log_vals) {
+    assert(distributed_);
+    const int owner = TargetOwner();
+    const int root = owner / nlocal_;
+    target_v_.resize(v[0].size());
+    if (rank_ == root) {
+      target_v_ = v[owner % nlocal_];
+      target_log_val_ = log_vals[owner % nlocal_].LogVal();
+    }
+    SendToAll(target_v_, root);
+    SendToAll(target_log_val_, root);
+  }
+
+  /// Returns the local replica at `beta = 1`, or -1 if another process holds
+  /// it.
+  int TargetReplica() const noexcept {
+    const int r = TargetOwner() - Offset();
+    return r >= 0 && r < nlocal_ ? r : -1;
+  }
+
+  /// Returns the configuration at `beta = 1` and its log-value (only
+  /// available in distributed mode).
+  std::pair<Eigen::Ref<const RowMatrix<double>>,
+            Eigen::Ref<const Eigen::VectorXcd>>
+  Target() const {
+    assert(distributed_);
+    return {target_v_.transpose(),
+            Eigen::Map<const Eigen::VectorXcd>{&target_log_val_, 1}};
+  }
+
+  /// \brief Must be called at the end of every sweep.
+  ///
+  /// Every `kWindow` sweeps of the warm-up phase, the logarithm of the gap
+  /// `beta_[r - 1] - beta_[r]` is increased by `kappa * (A_r - <A>)`, where
+  /// `A_r` is the measured exchange acceptance of the pair and `<A>` its mean
+  /// over all pairs. Pairs which exchange too often thus get further apart.
+  /// The gaps are then rescaled to keep both ends of the ladder fixed. The
+  /// step size `kappa` decreases with the number of steps so that the ladder
+  /// converges.
+  void EndSweep() {
+    if (adaptive_sweeps_ == 0) {
+      return;
+    }
+    --adaptive_sweeps_;
+    if (++window_sweeps_ < kWindow && adaptive_sweeps_ > 0) {
+      return;
+    }
+    window_sweeps_ = 0;
+
+    const auto npairs = static_cast<Index>(beta_.size()) - 1;
+    if (npairs >= 2 && (moves_.array() > 0).all()) {
+      const Eigen::ArrayXd acceptance = accepts_.array() / moves_.array();
+      const double kappa = 1. / (1. + 0.1 * steps_);
+      Eigen::ArrayXd gaps(npairs);
+      for (Index i = 0; i < npairs; ++i) {
+        gaps(i) = beta_[i] - beta_[i + 1];
+      }
+      const double span = gaps.sum();
+      gaps *= (kappa * (acceptance - acceptance.mean())).exp();
+      gaps *= span / gaps.sum();
+      for (Index i = 0; i + 1 < npairs; ++i) {
+        beta_[i + 1] = beta_[i] - gaps(i);
+      }
+      ++steps_;
+    }
+    accepts_.setZero();
+    moves_.setZero();
+  }
+
+  /// Writes the ladder and the state of its adaptation to \p stream.
+  void Save(std::ostream& stream) const {
+    WriteBinary(stream, distributed_);
+    WriteBinary(stream, beta_);
+    WriteBinary(stream, temperature_);
+    WriteBinary(stream, accepts_);
+    WriteBinary(stream, moves_);
+    WriteBinary(stream, adaptive_sweeps_);
+    WriteBinary(stream, window_sweeps_);
+    WriteBinary(stream, steps_);
+  }
+
+  /// \brief Reads a ladder written by #Save().
+  ///
+  /// The ladder must have the same size and be in the same mode as the saved
+  /// one. The configuration at `beta = 1` is not restored, the sampler has to
+  /// call #SyncTarget() afterwards in distributed mode.
+  void Load(std::istream& stream) {
+    bool distributed;
+    ReadBinary(stream, distributed);
+    NETKET_CHECK(distributed == distributed_, InvalidInputError,
+                 "saved temperature ladder is "
+                     << (distributed ? "" : "not ") << "distributed");
+    ReadBinary(stream, beta_);
+    ReadBinary(stream, temperature_);
+    ReadBinary(stream, accepts_);
+    ReadBinary(stream, moves_);
+    ReadBinary(stream, adaptive_sweeps_);
+    ReadBinary(stream, window_sweeps_);
+    ReadBinary(stream, steps_);
+  }
+
+ private:
+  /// Index of the first local replica in the ladder.
+  int Offset() const noexcept { return distributed_ ? rank_ * nlocal_ : 0; }
+
+  /// Index in the ladder of the replica at `beta = 1`.
+  int TargetOwner() const noexcept {
+    return static_cast<int>(
+        std::find(temperature_.begin(), temperature_.end(), 0) -
+        temperature_.begin());
+  }
+
+  /// \brief Runs the passes of exchanges of temperatures in \p temperature.
+  ///
+  /// `swap(r, g1, g2)` is called for every pair of temperatures `(r - 1, r)`,
+  /// `g1` and `g2` being the replicas currently at `r` and `r - 1`, and
+  /// returns whether the two replicas exchange their temperatures.
+  template <class Swap>
+  static void ExchangePasses(std::vector<int>& temperature, Swap&& swap) {
+    const int size = static_cast<int>(temperature.size());
+    std::vector<int> replica(size);
+    for (int g = 0; g < size; g++) {
+      replica[temperature[g]] = g;
+    }
+    for (const int start : {1, 2}) {
+      for (int r = start; r < size; r += 2) {
+        const int g1 = replica[r];
+        const int g2 = replica[r - 1];
+        if (swap(r, g1, g2)) {
+          std::swap(temperature[g1], temperature[g2]);
+          std::swap(replica[r], replica[r - 1]);
+        }
+      }
+    }
+  }
+};
+
+}  // namespace netket
+
+#endif  // NETKET_TEMPERATURE_LADDER_HPP
@@ -0,0 +1,128 @@
+// Copyright 2019 The Simons Foundation, Inc. - All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef NETKET_THINNING_CONTROLLER_HPP
+#define NETKET_THINNING_CONTROLLER_HPP
+
+#include <algorithm>
+#include <cmath>
+
+#include <Eigen/Core>
+#include <nonstd/optional.hpp>
+#include "Stats/mc_stats.hpp"
+#include "Utils/exceptions.hpp"
+#include "common_types.hpp"
+
+namespace netket {
+
+/// \brief Chooses how many sweeps separate two stored samples (thinning) and
+/// how many sweeps are discarded before sampling, based on the measured
+/// autocorrelation of the samples.
+///
+/// After every Monte Carlo run, #Update() estimates the integrated
+/// autocorrelation time in units of sweeps and picks the thinning such that
+/// the autocorrelation time of the stored samples is close to the target.
+/// The number of discarded sweeps is set to a few autocorrelation times,
+/// since the chains only need to forget the previous variational
+/// parameters.
+class ThinningController {
+  nonstd::optional<double> target_;
+  /// Smoothed estimate of the autocorrelation time in units of sweeps.
+  nonstd::optional<double> tau_sweeps_;
+  Index thinning_;
+  Index discard_;
+
+  /// Number of autocorrelation times discarded before sampling
+  static constexpr double kDiscardTaus = 5.0;
+  /// Weight of a new estimate in #tau_sweeps_
+  static constexpr double kSmoothing = 0.5;
+  /// Number of blocks used to estimate the autocorrelation of a single chain
+  static constexpr Index kBlocks = 8;
+
+ public:
+  ThinningController() : target_{}, tau_sweeps_{}, thinning_{1}, discard_{0} {}
+
+  /// \brief Sets the target autocorrelation time of the stored samples.
+  ///
+  /// `nullopt` disables the controller. \p discard is the number of
+  /// discarded sweeps until the first estimate is available.
+  void SetTarget(nonstd::optional<double> target, Index discard) {
+    NETKET_CHECK(!target.has_value() || *target >= 0, InvalidInputError,
+                 "invalid target autocorrelation time: "
+                     << *target << "; expected a non-negative number");
+    target_ = target;
+    tau_sweeps_ = nonstd::nullopt;
+    thinning_ = 1;
+    discard_ = discard;
+  }
+
+  const nonstd::optional<double>& Target() const noexcept { return target_; }
+  bool IsEnabled() const noexcept { return target_.has_value(); }
+
+  /// Number of sweeps between two stored samples.
+  Index Thinning() const noexcept { return thinning_; }
+  /// Number of sweeps discarded before sampling.
+  Index Discard() const noexcept { return discard_; }
+
+  /// \brief Updates the thinning and the number of discarded sweeps.
+  ///
+  /// \param stats Statistics of \p values, as returned by Statistics().
+  /// \param values Local values of the samples obtained with the current
+  /// #Thinning(), as passed to Statistics().
+  /// \param n_chains Number of Markov chains interleaved in \p values.
+  /// \param shared_chains Whether all MPI processes hold the same chains, as
+  /// passed to Statistics().
+  void Update(const Stats& stats, Eigen::Ref<const Eigen::VectorXcd> values,
+              Index n_chains, bool shared_chains = false) {
+    if (!IsEnabled()) {
+      return;
+    }
+    auto tau = stats.correlation;
+    // With a single Markov chain, Statistics() can't compare chains with each
+    // other, so the chain is split into blocks instead.
+    if (std::isnan(tau) && n_chains == 1 && values.size() >= 2 * kBlocks) {
+      const auto n = values.size() / kBlocks;
+      Eigen::VectorXcd blocks(n * kBlocks);
+      for (auto b = Index{0}; b < kBlocks; ++b) {
+        for (auto i = Index{0}; i < n; ++i) {
+          blocks(i * kBlocks + b) = values(b * n + i);
+        }
+      }
+      tau = Statistics(blocks, kBlocks, shared_chains).correlation;
+    }
+    if (std::isnan(tau)) {
+      return;
+    }
+
+    // Thinning by t sweeps divides 1 + 2τ by t
+    const auto tau_sweeps =
+        0.5 * ((1.0 + 2.0 * tau) * static_cast<double>(thinning_) - 1.0);
+    tau_sweeps_ = tau_sweeps_.has_value()
+                      ? kSmoothing * tau_sweeps + (1.0 - kSmoothing) * *tau_sweeps_
+                      : tau_sweeps;
+
+    // The thinning at most doubles or halves in one step, so that a single
+    // noisy estimate can't throw it off
+    const auto thinning = static_cast<Index>(
+        std::ceil((1.0 + 2.0 * *tau_sweeps_) / (1.0 + 2.0 * *target_)));
+    thinning_ = std::max(std::min(thinning, 2 * thinning_),
+                         std::max(thinning_ / 2, Index{1}));
+    discard_ = std::max(
+        static_cast<Index>(std::ceil(kDiscardTaus * *tau_sweeps_)), thinning_);
+  }
+};
+
+}  // namespace netket
+
+#endif  // NETKET_THINNING_CONTROLLER_HPP
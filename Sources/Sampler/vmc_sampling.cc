@@ -59,13 +59,17 @@ void SubtractMean(RowMatrix<Complex>& gradients) {
 
 MCResult ComputeSamples(AbstractSampler& sampler, Index num_samples,
                         Index num_skipped,
-                        nonstd::optional<std::string> der_logs) {
+                        nonstd::optional<std::string> der_logs,
+                        Index num_thin) {
   NETKET_CHECK(num_samples >= 0, InvalidInputError,
                "invalid number of samples: "
                    << num_samples << "; expected a non-negative integer");
   NETKET_CHECK(num_skipped >= 0, InvalidInputError,
                "invalid number of samples to discard: "
                    << num_skipped << "; expected a non-negative integer");
+  NETKET_CHECK(num_thin > 0, InvalidInputError,
+               "invalid thinning: " << num_thin
+                                    << "; expected a positive integer");
   NETKET_CHECK(
       !der_logs.has_value() ||
           (*der_logs == "normal" || *der_logs == "centered"),
@@ -119,7 +123,9 @@ MCResult ComputeSamples(AbstractSampler& sampler, Index num_samples,
   if (num_batches > 0) {
     record();
     for (auto i = Index{1}; i < num_batches; ++i) {
-      sampler.Sweep();
+      for (auto j = Index{0}; j < num_thin; ++j) {
+        sampler.Sweep();
+      }
       record();
     }
   }
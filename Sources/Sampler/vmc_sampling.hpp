@@ -42,6 +42,10 @@ struct MCResult {
 /**
  * Runs Monte Carlo sampling.
  *
+ * Markov chains continue from the current state of \p sampler:
+ * `sampler.Reset()` only refreshes log-values and look-up tables, e.g. after
+ * the parameters of the machine have changed.
+ *
  * @param sampler Sampler to use.
  * @param n_samples Minimal number of samples to generate. The actual number of
  *                  generated samples is \p n_samples rounded up to the closest
@@ -51,10 +55,12 @@ struct MCResult {
  *                  wavefunction. `nullopt` means don't compute the derivatives,
  *                  "normal" means compute the derivatives, and "centered" means
  *                  center them after computing.
+ * @param n_thin    Number of #Sweep() s between two recorded batches.
  */
 MCResult ComputeSamples(AbstractSampler &sampler, Index n_samples,
                         Index n_discard,
-                        nonstd::optional<std::string> der_logs);
+                        nonstd::optional<std::string> der_logs,
+                        Index n_thin = 1);
 
 /**
  * Computes gradient of an observable with respect to the variational parameters
@@ -14,6 +14,8 @@
 
 #include "Stats/mc_stats.hpp"
 
+#include <algorithm>
+
 #include <mpi.h>
 #include <nonstd/span.hpp>
 
@@ -102,7 +104,7 @@ std::pair<Eigen::VectorXcd, Eigen::VectorXd> StatisticsLocal(
 }
 
 Stats Statistics(Eigen::Ref<const Eigen::VectorXcd> values,
-                 Index local_number_chains) {
+                 Index local_number_chains, bool shared_chains) {
   NETKET_CHECK(values.size() >= local_number_chains, InvalidInputError,
                "not enough samples to compute statistics");
   constexpr auto NaN = std::numeric_limits<double>::quiet_NaN();
@@ -111,31 +113,39 @@ Stats Statistics(Eigen::Ref<const Eigen::VectorXcd> values,
   const auto n = values.size() / local_number_chains;
   // Total number of Markov Chains we have:
   //   #processes x local_number_chains
-  const auto m = []() {
-    int size;
-    MPI_Comm_size(MPI_COMM_WORLD, &size);
-    return static_cast<Index>(size);
-  }() * local_number_chains;
+  // unless all processes hold the same ones
+  const auto size = [shared_chains]() {
+    int nprocs = 1;
+    if (!shared_chains) {
+      MPI_Comm_size(MPI_COMM_WORLD, &nprocs);
+    }
+    return nprocs;
+  }();
+  const auto m = static_cast<Index>(size) * local_number_chains;
 
   // Calculates the mean over all Markov Chains
-  const auto mean = [&stats_local, m]() {
+  const auto mean = [&stats_local, m, size]() {
     // Sum over Markov Chains on this MPI node
     Complex local_mean = stats_local.first.sum();
     // Sum over all MPI nodes
-    Complex global_mean;
-    MPI_Allreduce(&local_mean, &global_mean, 1, MPI_DOUBLE_COMPLEX, MPI_SUM,
-                  MPI_COMM_WORLD);
+    Complex global_mean = local_mean;
+    if (size > 1) {
+      MPI_Allreduce(&local_mean, &global_mean, 1, MPI_DOUBLE_COMPLEX, MPI_SUM,
+                    MPI_COMM_WORLD);
+    }
     // Average
     return global_mean / static_cast<double>(m);
   }();
 
   // (B / n, W)
-  const auto var = [&stats_local, m, mean, NaN]() {
+  const auto var = [&stats_local, m, size, mean, NaN]() {
     double local_var[2] = {(stats_local.first.array() - mean).abs2().sum(),
                            stats_local.second.array().sum()};
-    double global_var[2];
-    MPI_Allreduce(&local_var, &global_var, 2, MPI_DOUBLE, MPI_SUM,
-                  MPI_COMM_WORLD);
+    double global_var[2] = {local_var[0], local_var[1]};
+    if (size > 1) {
+      MPI_Allreduce(&local_var, &global_var, 2, MPI_DOUBLE, MPI_SUM,
+                    MPI_COMM_WORLD);
+    }
     assert(m > 0);
     if (m == 1) {  // We can't estimate variance and error is there is only one
                    // chain.
@@ -147,9 +157,10 @@ Stats Statistics(Eigen::Ref<const Eigen::VectorXcd> values,
   }();
 
   if (!std::isnan(var.first) && !std::isnan(var.second)) {
+    // The variance of the chain means is (1 + 2τ) W / n
     const auto t = var.first / var.second;
-    auto correlation = 0.5 * (static_cast<double>(n) * t * t - 1.0);
-    if (correlation < 0.0) correlation = NaN;
+    const auto correlation =
+        std::max(0.5 * (static_cast<double>(n) * t - 1.0), 0.0);
     const auto R =
         std::sqrt(static_cast<double>(n - 1) / static_cast<double>(n) +
                   var.first / var.second);
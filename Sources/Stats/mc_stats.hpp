@@ -39,8 +39,11 @@ struct Stats {
 /// Since results from different markov chains are interleaved in `local_values`
 /// is is impotant to correctly specify `local_number_chains`. One can obtain it
 /// either from #AbstractSampler of #MCResult.
+///
+/// If `shared_chains` is true, all MPI processes hold the same chains (see
+/// AbstractSampler::SharesChains()) and only the local values are used.
 Stats Statistics(Eigen::Ref<const Eigen::VectorXcd> local_values,
-                 Index local_number_chains);
+                 Index local_number_chains, bool shared_chains = false);
 
 }  // namespace netket
 
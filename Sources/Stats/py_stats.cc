@@ -55,18 +55,19 @@ void AddStatsModule(py::module m) {
 
   subm.def(
       "statistics",
-      [](py::array_t<Complex, py::array::c_style> local_values) {
+      [](py::array_t<Complex, py::array::c_style> local_values,
+         bool shared_chains) {
         switch (local_values.ndim()) {
           case 2:
             return Statistics(
                 Eigen::Map<const Eigen::VectorXcd>{local_values.data(),
                                                    local_values.size()},
-                /*n_chains=*/local_values.shape(1));
+                /*n_chains=*/local_values.shape(1), shared_chains);
           case 1:
             return Statistics(
                 Eigen::Map<const Eigen::VectorXcd>{local_values.data(),
                                                    local_values.size()},
-                /*n_chains=*/1);
+                /*n_chains=*/1, shared_chains);
           default:
             NETKET_CHECK(false, InvalidInputError,
                          "local_values has wrong dimension: "
@@ -74,7 +75,7 @@ void AddStatsModule(py::module m) {
                              << "; expected either 1 or 2.");
         }  // end switch
       },
-      py::arg{"values"}.noconvert(),
+      py::arg{"values"}.noconvert(), py::arg{"shared_chains"} = false,
       R"EOF(Computes some statistics (see `Stats` class) of a sequence of
             local estimators obtained from Monte Carlo sampling.
 
@@ -86,7 +87,11 @@ void AddStatsModule(py::module m) {
 
                     Rank-2 tensors should have shape `(N, M)` where `N` is the
                     number of samples in one Markov Chain and `M` is the number
-                    of Markov Chains. Data should be in row major order.)EOF");
+                    of Markov Chains. Data should be in row major order.
+                shared_chains: Whether all MPI processes hold the same Markov
+                    Chains, e.g. when sampling with a distributed temperature
+                    ladder (see `Sampler.shares_chains`). They are then
+                    counted only once.)EOF");
 }
 }  // namespace detail
 }  // namespace netket
@@ -86,7 +86,8 @@ void AddSupervisedModule(py::module &m) {
       .def_property_readonly(
           "loss_mse_log", &Supervised::GetMseLog,
           R"EOF(double: The mean square error of the log of amplitudes.)EOF")
-      .def("run", &Supervised::Run, py::arg("n_iter"),
+      .def("run", &Supervised::Run, py::call_guard<py::gil_scoped_release>(),
+           py::arg("n_iter"),
            py::arg("loss_function") = "Overlap_phi",
            py::arg("output_prefix") = "output",
            py::arg("save_params_every") = 50, R"EOF(
@@ -100,6 +101,7 @@ void AddSupervisedModule(py::module &m) {
 
            )EOF")
       .def("advance", &Supervised::Advance,
+           py::call_guard<py::gil_scoped_release>(),
            py::arg("loss_function") = "Overlap_phi", R"EOF(
            Run one iteration of supervised learning. This should be helpful for testing and
            having self-defined control sequence in python.
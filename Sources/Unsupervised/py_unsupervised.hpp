@@ -65,12 +65,13 @@ void AddUnsupervisedModule(py::module &m) {
            py::arg("use_cholesky") = true)
       .def("add_observable", &QuantumStateReconstruction::AddObservable,
            py::keep_alive<1, 2>())
-      .def("run", &QuantumStateReconstruction::Run, py::arg("output_prefix"),
+      .def("run", &QuantumStateReconstruction::Run,
+           py::call_guard<py::gil_scoped_release>(), py::arg("output_prefix"),
            py::arg("n_iter"), py::arg("step_size") = 1,
            py::arg("save_params_every") = 50)
       .def("reset", &QuantumStateReconstruction::Reset)
       .def("advance", &QuantumStateReconstruction::Advance,
-           py::arg("steps") = 1,
+           py::call_guard<py::gil_scoped_release>(), py::arg("steps") = 1,
            R"EOF(
                       Perform one or several iteration steps of the Qsr calculation. In each step,
                       the gradient will be estimated via negative and positive phase and subsequently,
@@ -83,7 +84,10 @@ void AddUnsupervisedModule(py::module &m) {
       .def("get_observable_stats",
            [](QuantumStateReconstruction &self) {
              py::dict data;
-             self.ComputeObservables();
+             {
+               py::gil_scoped_release release;
+               self.ComputeObservables();
+             }
              self.GetObsManager().InsertAllStats(data);
              return data;
            },
@@ -15,6 +15,7 @@
 #ifndef NETKET_ALLUTILS_HPP
 #define NETKET_ALLUTILS_HPP
 
+#include "binary_io.hpp"
 #include "exceptions.hpp"
 #include "json_utils.hpp"
 #include "kronecker_product.hpp"
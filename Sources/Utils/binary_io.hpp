@@ -0,0 +1,118 @@
+// Copyright 2019 The Simons Foundation, Inc. - All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef NETKET_BINARY_IO_HPP
+#define NETKET_BINARY_IO_HPP
+
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <Eigen/Core>
+
+#include "Utils/exceptions.hpp"
+
+/// \file
+/// Helpers to (de)serialize plain values, strings, std::vectors and Eigen
+/// matrices to/from a compact binary format.
+///
+/// The format is the raw memory representation of the values, so it is only
+/// meant to be read back on the same platform (e.g. for checkpoints). Sizes
+/// are stored as 64-bit integers.
+
+namespace netket {
+
+template <class T>
+typename std::enable_if<std::is_trivially_copyable<T>::value>::type
+WriteBinary(std::ostream& stream, const T& value) {
+  stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <class T>
+typename std::enable_if<std::is_trivially_copyable<T>::value>::type ReadBinary(
+    std::istream& stream, T& value) {
+  stream.read(reinterpret_cast<char*>(&value), sizeof(T));
+  NETKET_CHECK(stream, RuntimeError, "unexpected end of binary data");
+}
+
+inline void WriteBinary(std::ostream& stream, const std::string& value) {
+  WriteBinary(stream, static_cast<std::int64_t>(value.size()));
+  stream.write(value.data(), static_cast<std::streamsize>(value.size()));
+}
+
+inline void ReadBinary(std::istream& stream, std::string& value) {
+  std::int64_t size;
+  ReadBinary(stream, size);
+  NETKET_CHECK(size >= 0, RuntimeError, "corrupt binary data");
+  value.resize(static_cast<std::size_t>(size));
+  stream.read(&value[0], static_cast<std::streamsize>(size));
+  NETKET_CHECK(stream, RuntimeError, "unexpected end of binary data");
+}
+
+/// Writes the shape and the coefficients of \p matrix.
+template <class Derived>
+void WriteBinary(std::ostream& stream,
+                 const Eigen::PlainObjectBase<Derived>& matrix) {
+  using Scalar = typename Derived::Scalar;
+  WriteBinary(stream, static_cast<std::int64_t>(matrix.rows()));
+  WriteBinary(stream, static_cast<std::int64_t>(matrix.cols()));
+  stream.write(reinterpret_cast<const char*>(matrix.data()),
+               static_cast<std::streamsize>(sizeof(Scalar) * matrix.size()));
+}
+
+/// \brief Reads the coefficients of \p matrix.
+///
+/// The stored shape must match the current shape of \p matrix, so that data
+/// written for a different system is rejected.
+template <class Derived>
+void ReadBinary(std::istream& stream, Eigen::PlainObjectBase<Derived>& matrix) {
+  using Scalar = typename Derived::Scalar;
+  std::int64_t rows, cols;
+  ReadBinary(stream, rows);
+  ReadBinary(stream, cols);
+  CheckShape("ReadBinary", "matrix", {rows, cols},
+             {matrix.rows(), matrix.cols()});
+  stream.read(reinterpret_cast<char*>(matrix.data()),
+              static_cast<std::streamsize>(sizeof(Scalar) * matrix.size()));
+  NETKET_CHECK(stream, RuntimeError, "unexpected end of binary data");
+}
+
+template <class T>
+void WriteBinary(std::ostream& stream, const std::vector<T>& values) {
+  WriteBinary(stream, static_cast<std::int64_t>(values.size()));
+  for (const auto& value : values) {
+    WriteBinary(stream, value);
+  }
+}
+
+/// \brief Reads the elements of \p values.
+///
+/// Like for Eigen matrices, the stored size must match the current one.
+template <class T>
+void ReadBinary(std::istream& stream, std::vector<T>& values) {
+  std::int64_t size;
+  ReadBinary(stream, size);
+  CheckShape("ReadBinary", "values", size, static_cast<long>(values.size()));
+  for (auto& value : values) {
+    ReadBinary(stream, value);
+  }
+}
+
+}  // namespace netket
+
+#endif  // NETKET_BINARY_IO_HPP
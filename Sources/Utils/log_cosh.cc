@@ -18,21 +18,23 @@
 namespace netket {
 namespace detail {
 namespace {
-inline double LogCosh(double x) noexcept {
+template <class T>
+inline T LogCosh(T x) noexcept {
   x = std::abs(x);
-  if (x <= 12.0) {
+  if (x <= T{12}) {
     return std::log(std::cosh(x));
   } else {
-    static const auto log2v = std::log(2.0);
+    static const auto log2v = std::log(T{2});
     return x - log2v;
   }
 }
 
-inline Complex LogCosh(Complex x) noexcept {
-  const double xr = x.real();
-  const double xi = x.imag();
-  Complex res = LogCosh(xr);
-  res += std::log(Complex(std::cos(xi), std::tanh(xr) * std::sin(xi)));
+template <class T>
+inline std::complex<T> LogCosh(std::complex<T> x) noexcept {
+  const T xr = x.real();
+  const T xi = x.imag();
+  std::complex<T> res = LogCosh(xr);
+  res += std::log(std::complex<T>(std::cos(xi), std::tanh(xr) * std::sin(xi)));
   return res;
 }
 }  // namespace
@@ -56,5 +58,26 @@ Complex SumLogCosh_generic(
   }
   return total;
 }
+Complex SumLogCosh_generic(
+    Eigen::Ref<const Eigen::Matrix<std::complex<float>, Eigen::Dynamic, 1>>
+        input,
+    Eigen::Ref<const Eigen::Matrix<std::complex<float>, Eigen::Dynamic, 1>>
+        bias) noexcept {
+  auto total = Complex{0.0, 0.0};
+  for (auto i = Index{0}; i < input.size(); ++i) {
+    total += static_cast<Complex>(LogCosh(input(i) + bias(i)));
+  }
+  return total;
+}
+
+Complex SumLogCosh_generic(
+    Eigen::Ref<const Eigen::Matrix<std::complex<float>, Eigen::Dynamic, 1>>
+        input) noexcept {
+  auto total = Complex{0.0, 0.0};
+  for (auto i = Index{0}; i < input.size(); ++i) {
+    total += static_cast<Complex>(LogCosh(input(i)));
+  }
+  return total;
+}
 }  // namespace detail
 }  // namespace netket
@@ -34,6 +34,14 @@ Complex SumLogCosh_generic(
     Eigen::Ref<const Eigen::Matrix<Complex, Eigen::Dynamic, 1>> bias) noexcept;
 Complex SumLogCosh_generic(
     Eigen::Ref<const Eigen::Matrix<Complex, Eigen::Dynamic, 1>> input) noexcept;
+Complex SumLogCosh_generic(
+    Eigen::Ref<const Eigen::Matrix<std::complex<float>, Eigen::Dynamic, 1>>
+        input,
+    Eigen::Ref<const Eigen::Matrix<std::complex<float>, Eigen::Dynamic, 1>>
+        bias) noexcept;
+Complex SumLogCosh_generic(
+    Eigen::Ref<const Eigen::Matrix<std::complex<float>, Eigen::Dynamic, 1>>
+        input) noexcept;
 }  // namespace detail
 
 /// Returns `∑log(cosh(inputᵢ + biasᵢ))`
@@ -65,6 +73,28 @@ inline Complex SumLogCosh(
   return detail::SumLogCosh_generic(input);
 #endif
 }
+
+/// Returns `∑log(cosh(inputᵢ + biasᵢ))` for single-precision input.
+///
+/// Individual terms are computed in single precision, but the sum is
+/// accumulated in double precision.
+inline Complex SumLogCosh(
+    Eigen::Ref<const Eigen::Matrix<std::complex<float>, Eigen::Dynamic, 1>>
+        input,
+    Eigen::Ref<const Eigen::Matrix<std::complex<float>, Eigen::Dynamic, 1>>
+        bias) noexcept {
+  return detail::SumLogCosh_generic(input, bias);
+}
+
+/// Returns `∑log(cosh(inputᵢ))` for single-precision input.
+///
+/// Individual terms are computed in single precision, but the sum is
+/// accumulated in double precision.
+inline Complex SumLogCosh(
+    Eigen::Ref<const Eigen::Matrix<std::complex<float>, Eigen::Dynamic, 1>>
+        input) noexcept {
+  return detail::SumLogCosh_generic(input);
+}
 }  // namespace netket
 
 #endif  // SOURCES_UTILS_LOG_COSH_HPP
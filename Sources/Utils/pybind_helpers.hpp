@@ -1,10 +1,15 @@
 #ifndef NETKET_PYBIND_HELPERS_HPP
 #define NETKET_PYBIND_HELPERS_HPP
 
+#include <pybind11/numpy.h>
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 #include <nonstd/optional.hpp>
 
+#include <type_traits>
+#include <utility>
+#include <vector>
+
 #include "exceptions.hpp"
 
 // This adds pybind11 support for nonstd::optional, see
@@ -46,6 +51,33 @@ Value GetOrThrow(const pybind11::kwargs& kwargs, std::string field) {
   }
 }
 
+/// Moves a row-major Eigen matrix (or a vector) to the heap and returns a
+/// NumPy array of the given shape viewing its data. The array owns the matrix
+/// through a capsule, so that no data is copied.
+template <class Matrix>
+pybind11::array_t<typename Matrix::Scalar, pybind11::array::c_style>
+MoveToNumpy(Matrix&& matrix, std::vector<pybind11::ssize_t> shape) {
+  static_assert(!std::is_lvalue_reference<Matrix>::value,
+                "MoveToNumpy takes ownership of the matrix");
+  static_assert(Matrix::IsRowMajor || Matrix::IsVectorAtCompileTime,
+                "MoveToNumpy requires C-contiguous data");
+  auto* owner = new Matrix{std::move(matrix)};
+  pybind11::capsule base{owner,
+                         [](void* p) { delete static_cast<Matrix*>(p); }};
+  return pybind11::array_t<typename Matrix::Scalar,
+                           pybind11::array::c_style>{std::move(shape),
+                                                     owner->data(), base};
+}
+
+template <class Matrix>
+pybind11::array_t<typename Matrix::Scalar, pybind11::array::c_style>
+MoveToNumpy(Matrix&& matrix) {
+  if (Matrix::IsVectorAtCompileTime) {
+    return MoveToNumpy(std::move(matrix), {matrix.size()});
+  }
+  return MoveToNumpy(std::move(matrix), {matrix.rows(), matrix.cols()});
+}
+
 }  // namespace netket
 
 #endif  // NETKET_PYBIND_HELPERS_HPP
@@ -15,12 +15,17 @@
 #ifndef NETKET_RANDOMUTILS_HPP
 #define NETKET_RANDOMUTILS_HPP
 
+#include <cassert>
+#include <cmath>
 #include <complex>
+#include <numeric>
 #include <random>
+#include <vector>
 
 #include <mpi.h>
 #include <Eigen/Dense>
 
+#include "Utils/exceptions.hpp"
 #include "Utils/mpi_interface.hpp"
 #include "common_types.hpp"
 
@@ -69,6 +74,7 @@ class DistributedRandomEngine {
    * Returns the underlying random engine.
    */
   default_random_engine &Get() { return engine_; }
+  const default_random_engine &Get() const { return engine_; }
 
   /**
    * Resets the seeds of the random engines of all MPI processes from the given
@@ -120,6 +126,79 @@ class DistributedRandomEngine {
   }
 };
 
+/**
+ * Samples indices from a discrete distribution in constant time using
+ * Walker's alias method. The table is built in linear time (Vose's
+ * algorithm), whereas std::discrete_distribution needs logarithmic time per
+ * sample.
+ */
+class AliasTable {
+ public:
+  AliasTable() = default;
+
+  /**
+   * Builds the table for the distribution with the given (not necessarily
+   * normalized) weights.
+   */
+  explicit AliasTable(const std::vector<double> &weights)
+      : prob_(weights.size()), alias_(weights.size()) {
+    const auto n = static_cast<int>(weights.size());
+    const double sum = std::accumulate(weights.begin(), weights.end(), 0.0);
+    if (n == 0 || !(sum > 0) || !std::isfinite(sum)) {
+      throw InvalidInputError{
+          "invalid weights: expected a non-empty list of non-negative "
+          "numbers with a positive and finite sum"};
+    }
+
+    // Weights are rescaled so that their mean is 1. Columns with a smaller
+    // weight are then filled up by columns with a larger one.
+    std::vector<int> small;
+    std::vector<int> large;
+    for (int i = 0; i < n; ++i) {
+      prob_[i] = weights[i] * n / sum;
+      (prob_[i] < 1. ? small : large).push_back(i);
+    }
+    while (!small.empty() && !large.empty()) {
+      const int s = small.back();
+      small.pop_back();
+      const int l = large.back();
+      alias_[s] = l;
+      prob_[l] = (prob_[l] + prob_[s]) - 1.;
+      if (prob_[l] < 1.) {
+        large.pop_back();
+        small.push_back(l);
+      }
+    }
+    // Only round-off errors are left
+    for (const int i : small) {
+      prob_[i] = 1.;
+      alias_[i] = i;
+    }
+    for (const int i : large) {
+      prob_[i] = 1.;
+      alias_[i] = i;
+    }
+  }
+
+  int Size() const noexcept { return static_cast<int>(prob_.size()); }
+
+  /**
+   * Draws a random index.
+   */
+  template <class Engine>
+  int operator()(Engine &engine) const {
+    assert(Size() > 0);
+    const int i = std::uniform_int_distribution<int>{0, Size() - 1}(engine);
+    return std::uniform_real_distribution<double>{}(engine) < prob_[i]
+               ? i
+               : alias_[i];
+  }
+
+ private:
+  std::vector<double> prob_;
+  std::vector<int> alias_;
+};
+
 }  // namespace netket
 
 #endif
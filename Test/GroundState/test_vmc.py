@@ -76,6 +76,23 @@ def test_vmc_functions():
     )
 
 
+def test_mc_result_views():
+    ha, _, ma, sampler, _ = _setup_vmc()
+
+    data = vmc.compute_samples(sampler, n_samples=100, n_discard=10, der_logs="normal")
+    samples, log_values, der_logs = data.samples, data.log_values, data.der_logs
+    assert samples.base is not None and not samples.flags.writeable
+    assert np.shares_memory(data.der_logs, der_logs)
+
+    # The views keep the underlying result alive
+    del data
+    n_chains = sampler.batch_size
+    assert der_logs.shape == (samples.shape[0], n_chains, ma.n_par)
+    for i in range(n_chains):
+        assert log_values[:, i] == approx(ma.log_val(samples[:, i]))
+        assert der_logs[:, i] == approx(ma.der_log(samples[:, i]))
+
+
 def test_vmc_use_cholesky_compatibility():
     ha, _, ma, sampler, _ = _setup_vmc()
 
@@ -87,3 +104,73 @@ def test_vmc_use_cholesky_compatibility():
         vmc = nk.variational.Vmc(
             ha, sampler, op, 1000, use_cholesky=True, sr_lsq_solver="BDCSVD"
         )
+
+
+def _setup_metropolis_vmc(**sampler_args):
+    g = nk.graph.Hypercube(length=8, n_dim=1)
+    hi = nk.hilbert.Spin(s=0.5, graph=g)
+    ma = nk.machine.RbmSpin(hilbert=hi, alpha=1)
+    ma.init_random_parameters(seed=SEED, sigma=0.01)
+    ha = nk.operator.Ising(hi, h=1.0)
+    sa = nk.sampler.MetropolisLocalV2(machine=ma, batch_size=4, **sampler_args)
+    sa.seed(SEED)
+    op = nk.optimizer.Sgd(learning_rate=0.01)
+
+    driver = nk.variational.Vmc(ha, sa, op, 500, discarded_samples=50)
+
+    return ma, sa, driver
+
+
+def test_vmc_target_autocorrelation():
+    _, _, driver = _setup_metropolis_vmc(sweep_size=1)
+    assert driver.target_autocorrelation is None
+    assert driver.thinning == 1
+    assert driver.n_discard == 50
+
+    # Sweeps made of a single spin flip are strongly correlated, so the
+    # thinning has to grow
+    driver.target_autocorrelation = 0.5
+    assert driver.target_autocorrelation == approx(0.5)
+    driver.advance(10)
+    assert driver.thinning > 1
+    assert driver.n_discard >= driver.thinning
+
+    driver.target_autocorrelation = None
+    assert driver.thinning == 1
+    assert driver.n_discard == 50
+
+
+def test_vmc_persistent_chains():
+    ma, sa, driver = _setup_metropolis_vmc()
+    assert not driver.persistent_chains
+    driver.persistent_chains = True
+    assert driver.n_discard == 50
+
+    # Chains are only thermalized in the first iteration
+    driver.advance(1)
+    assert driver.n_discard == 1
+    driver.advance(1)
+    assert driver.n_discard == 1
+
+    # Log-values of the kept chains are refreshed for the new parameters: the
+    # first batch is recorded before any sweep
+    ma.init_random_parameters(seed=SEED + 1, sigma=0.01)
+    data = vmc.compute_samples(sa, n_samples=4, n_discard=0)
+    assert data.log_values[0] == approx(ma.log_val(data.samples[0]))
+
+    driver.reset()
+    assert driver.n_discard == 50
+
+
+def test_vmc_sampler_checkpoint(tmp_path):
+    _, _, driver = _setup_metropolis_vmc()
+
+    prefix = str(tmp_path / "vmc")
+    driver.persistent_chains = True
+    driver.run(output_prefix=prefix, n_iter=1)
+
+    # Resuming from the checkpoint does not thermalize the chains again
+    driver.reset()
+    assert driver.n_discard == 50
+    driver.load_sampler_state(prefix + ".sampler")
+    assert driver.n_discard == 1
@@ -39,6 +39,10 @@ machines["Jastrow 1d Hypercube spin"] = nk.machine.Jastrow(hilbert=hi)
 hi = nk.hilbert.Spin(s=0.5, graph=g, total_sz=0)
 machines["Jastrow 1d Hypercube spin"] = nk.machine.JastrowSymm(hilbert=hi)
 
+machines["Product Jastrow RbmSpin"] = nk.machine.ProductMachine(
+    hi, (nk.machine.Jastrow(hilbert=hi), nk.machine.RbmSpin(hilbert=hi, alpha=1))
+)
+
 dm_machines = {}
 dm_machines["Phase NDM"] = nk.machine.NdmSpinPhase(
     hilbert=hi,
@@ -74,6 +78,22 @@ layers = (
 # FFNN Machine
 machines["FFFN 1d Hypercube spin Convolutional Hypercube"] = nk.machine.FFNN(hi, layers)
 
+layers = (
+    nk.layer.ConvolutionalHypercube(
+        length=4, n_dim=1, input_channels=1, output_channels=2, kernel_length=2
+    ),
+    nk.layer.Lncosh(input_size=8),
+    nk.layer.ConvolutionalHypercube(
+        length=4, n_dim=1, input_channels=2, output_channels=2, kernel_length=3
+    ),
+    nk.layer.Tanh(input_size=8),
+    nk.layer.FullyConnected(input_size=8, output_size=3, use_bias=True),
+    nk.layer.Lncosh(input_size=3),
+)
+
+# Deep FFNN Machine
+machines["FFFN 1d Hypercube spin deep"] = nk.machine.FFNN(hi, layers)
+
 machines["MPS Diagonal 1d spin"] = nk.machine.MPSPeriodicDiagonal(hi, bond_dim=3)
 machines["MPS 1d spin"] = nk.machine.MPSPeriodic(hi, bond_dim=3)
 
@@ -261,3 +281,42 @@ def test_nvisible():
 
         assert machine.n_visible == hip.size
         assert machine.n_visible * 2 == hi.size
+
+
+def test_single_precision():
+    g = nk.graph.Hypercube(length=8, n_dim=1)
+    hi = nk.hilbert.Spin(s=0.5, graph=g)
+    ma = nk.machine.RbmSpinV2(hilbert=hi, alpha=2)
+    ma_single = nk.machine.RbmSpinV2(hilbert=hi, alpha=2, single_precision=True)
+    assert ma_single.single_precision and not ma.single_precision
+
+    ma.init_random_parameters(seed=1234, sigma=0.1)
+    ma_single.parameters = ma.parameters
+
+    rg = nk.utils.RandomEngine(seed=1234)
+    v = np.zeros((16, hi.size))
+    for i in range(v.shape[0]):
+        hi.random_vals(v[i], rg)
+
+    assert ma_single.log_val(v) == approx(ma.log_val(v), rel=1e-5, abs=1e-5)
+    assert ma_single.der_log(v) == approx(ma.der_log(v), rel=1e-5, abs=1e-5)
+
+
+def test_batched_log_val():
+    for name, machine in machines.items():
+        print("Machine test: %s" % name)
+
+        npar = machine.n_par
+        machine.parameters = 0.1 * (np.random.randn(npar) + 1.0j * np.random.randn(npar))
+
+        hi = machine.hilbert
+        rg = nk.utils.RandomEngine(seed=1234)
+        v = np.zeros((8, hi.size))
+        for i in range(v.shape[0]):
+            hi.random_vals(v[i], rg)
+
+        log_val = machine.log_val(v)
+        der_log = machine.der_log(v)
+        for i in range(v.shape[0]):
+            assert log_val[i] == approx(machine.log_val(v[i]))
+            assert der_log[i] == approx(machine.der_log(v[i]))
@@ -103,6 +103,17 @@ def test_produce_elements_in_hilbert():
                     assert rs in local_states
 
 
+def test_n_conn():
+    for name, ha in operators.items():
+        hi = ha.hilbert
+        print(name, hi)
+        rstate = np.zeros(hi.size)
+
+        for i in range(100):
+            hi.random_vals(rstate, rg)
+            assert ha.n_conn(rstate) == len(ha.get_conn(rstate)[0])
+
+
 def test_operator_is_hermitean():
     for name, ha in operators.items():
         hi = ha.hilbert
@@ -22,9 +22,34 @@ samplers["MetropolisLocal RbmSpin"] = sa
 sa = nk.sampler.MetropolisLocalV2(machine=ma, batch_size=1)
 samplers["MetropolisLocalV2 RbmSpin"] = sa
 
+sa = nk.sampler.MetropolisLocalV2(machine=ma, batch_size=1, use_lookup=True)
+samplers["MetropolisLocalV2 RbmSpin with look-up tables"] = sa
+
+ma_jastrow = nk.machine.Jastrow(hilbert=hi)
+ma_jastrow.init_random_parameters(seed=1234, sigma=0.2)
+sa = nk.sampler.MetropolisLocalV2(machine=ma_jastrow, batch_size=1, use_lookup=True)
+samplers["MetropolisLocalV2 Jastrow with look-up tables"] = sa
+
 sa = nk.sampler.MetropolisLocalPt(machine=ma, n_replicas=4)
 samplers["MetropolisLocalPt RbmSpin"] = sa
 
+sa = nk.sampler.ExactSampler(machine=ma)
+samplers["ExactSampler RbmSpin"] = sa
+
+sa = nk.sampler.MetropolisHopV2(machine=ma, batch_size=1)
+samplers["MetropolisHopV2 RbmSpin"] = sa
+
+sa = nk.sampler.MetropolisHopV2(machine=ma, d_max=2, batch_size=1, use_lookup=True)
+samplers["MetropolisHopV2 RbmSpin with look-up tables"] = sa
+
+sa = nk.sampler.MetropolisClusterV2(machine=ma, antiferromagnetic=False, batch_size=1)
+samplers["MetropolisClusterV2 RbmSpin"] = sa
+
+sa = nk.sampler.MetropolisClusterV2(
+    machine=ma, bond_probability=0.8, batch_size=1, use_lookup=True
+)
+samplers["MetropolisClusterV2 RbmSpin antiferromagnetic with look-up tables"] = sa
+
 ha = nk.operator.Ising(hilbert=hi, h=1.0)
 sa = nk.sampler.MetropolisHamiltonian(machine=ma, hamiltonian=ha)
 samplers["MetropolisHamiltonian RbmSpin"] = sa
@@ -83,6 +108,14 @@ move_op = nk.operator.LocalOperator(hilbert=hi, operators=ops, acting_on=acting_
 sa = nk.sampler.CustomSampler(machine=ma, move_operators=move_op)
 samplers["CustomSampler Spin 2 moves"] = sa
 
+sa = nk.sampler.CustomSamplerV2(machine=ma, move_operators=move_op, batch_size=1)
+samplers["CustomSamplerV2 Spin 2 moves"] = sa
+
+sa = nk.sampler.CustomSamplerV2(
+    machine=ma, move_operators=move_op, batch_size=1, use_lookup=True
+)
+samplers["CustomSamplerV2 Spin 2 moves with look-up tables"] = sa
+
 # Diagonal density matrix sampling
 ma = nk.machine.NdmSpinPhase(
     hilbert=hi,
@@ -191,3 +224,149 @@ def test_correct_sampling():
 
         s, pval = combine_pvalues(pvalues, method="fisher")
         assert pval > 0.01 or np.max(pvalues) > 0.01
+
+
+def _setup_chain(total_sz=None):
+    g = nk.graph.Hypercube(length=6, n_dim=1)
+    if total_sz is None:
+        hi = nk.hilbert.Spin(s=0.5, graph=g)
+    else:
+        hi = nk.hilbert.Spin(s=0.5, graph=g, total_sz=total_sz)
+    ma = nk.machine.RbmSpin(hilbert=hi, alpha=1)
+    ma.init_random_parameters(seed=1234, sigma=0.2)
+    return g, hi, ma
+
+
+def _nearest_neighbour_exchanges(hi):
+    exchange = [[1, 0, 0, 0], [0, 0, 1, 0], [0, 1, 0, 0], [0, 0, 0, 1]]
+    return nk.operator.LocalOperator(
+        hilbert=hi,
+        operators=[exchange] * hi.size,
+        acting_on=[[i, (i + 1) % hi.size] for i in range(hi.size)],
+    )
+
+
+@pytest.mark.parametrize("use_lookup", [False, True])
+@pytest.mark.parametrize(
+    "make_sampler",
+    [
+        lambda g, hi, ma, use_lookup: nk.sampler.MetropolisExchangeV2(
+            machine=ma, graph=g, d_max=1, batch_size=8, use_lookup=use_lookup
+        ),
+        lambda g, hi, ma, use_lookup: nk.sampler.CustomSamplerV2(
+            machine=ma,
+            move_operators=_nearest_neighbour_exchanges(hi),
+            batch_size=8,
+            use_lookup=use_lookup,
+        ),
+        lambda g, hi, ma, use_lookup: nk.sampler.MetropolisClusterV2(
+            machine=ma, conserve_total=True, batch_size=8, use_lookup=use_lookup
+        ),
+    ],
+    ids=["MetropolisExchangeV2", "CustomSamplerV2", "MetropolisClusterV2"],
+)
+def test_v2_samplers_conserve_magnetization(make_sampler, use_lookup):
+    g, hi, ma = _setup_chain(total_sz=0)
+    sa = make_sampler(g, hi, ma, use_lookup)
+    assert sa.use_lookup == use_lookup
+
+    for sw in range(100):
+        sa.sweep()
+        assert sa.visible.shape == (8, hi.size)
+        assert np.all(sa.visible.sum(axis=1) == 0)
+
+
+def test_adaptive_temperature_ladder():
+    g, hi, ma = _setup_chain()
+    ma.init_random_parameters(seed=1234, sigma=0.5)
+    sa = nk.sampler.MetropolisLocalPt(machine=ma, n_replicas=6)
+
+    assert sa.betas == approx([1.0 - i / 6 for i in range(6)])
+    assert sa.adaptive_sweeps == 0
+
+    sa.adaptive_sweeps = 100
+    for sw in range(60):
+        sa.sweep()
+    assert sa.adaptive_sweeps == 40
+    for sw in range(60):
+        sa.sweep()
+    assert sa.adaptive_sweeps == 0
+
+    # The ends of the ladder are fixed and the ladder stays ordered
+    betas = sa.betas
+    assert betas[0] == approx(1.0)
+    assert betas[-1] == approx(1.0 / 6)
+    assert np.all(np.diff(betas) < 0)
+
+    # Afterwards the ladder is frozen
+    for sw in range(20):
+        sa.sweep()
+    assert sa.betas == approx(betas)
+
+
+def test_distributed_temperature_ladder():
+    g, hi, ma = _setup_chain()
+    sa = nk.sampler.MetropolisLocalPt(machine=ma, n_replicas=3)
+
+    assert not sa.distributed
+    sa.distributed = True
+    assert sa.distributed
+    assert sa.shares_chains
+    assert len(sa.betas) == 3 * nk.MPI.size()
+    for sw in range(100):
+        sa.sweep()
+        assert sa.visible.shape == (1, hi.size)
+        for v in sa.visible.reshape(-1):
+            assert v in hi.local_states
+
+    sa.distributed = False
+    assert len(sa.betas) == 3
+    assert not sa.shares_chains
+
+
+def test_exact_sampler_batch():
+    g, hi, ma = _setup_chain()
+    sa = nk.sampler.ExactSampler(machine=ma, batch_size=16)
+
+    for sw in range(10):
+        sa.sweep()
+        assert sa.visible.shape == (16, hi.size)
+        for v in sa.visible.reshape(-1):
+            assert v in hi.local_states
+
+    # The log-values of the kept states are updated for the new parameters
+    ma.init_random_parameters(seed=4321, sigma=0.2)
+    data = nk.variational.compute_samples(sa, n_samples=16, n_discard=0)
+    assert data.log_values[0] == approx(ma.log_val(data.samples[0]))
+
+
+def test_save_load_state(tmp_path):
+    filename = str(tmp_path / "sampler.state")
+    for name, sa in samplers.items():
+        print("Sampler test: %s" % name)
+        sa.seed(1234)
+        for sw in range(10):
+            sa.sweep()
+        sa.save_state(filename)
+
+        visibles = []
+        for sw in range(10):
+            sa.sweep()
+            visibles.append(np.copy(sa.visible))
+
+        # Moves to a different state before restoring the saved one
+        sa.reset(True)
+        sa.load_state(filename)
+        for sw in range(10):
+            sa.sweep()
+            assert np.array_equal(sa.visible, visibles[sw])
+
+
+def test_cluster_v2_ferromagnetic_conserve_total():
+    _, _, ma = _setup_chain(total_sz=0)
+
+    # Ferromagnetic clusters cannot conserve the magnetization
+    with pytest.raises(ValueError):
+        nk.sampler.MetropolisClusterV2(
+            machine=ma, antiferromagnetic=False, conserve_total=True
+        )
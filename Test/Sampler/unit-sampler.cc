@@ -0,0 +1,181 @@
+// Copyright 2019 The Simons Foundation, Inc. - All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include <mpi.h>
+#include "catch.hpp"
+
+#include "Graph/hypercube.hpp"
+#include "Hilbert/spins.hpp"
+#include "Machine/rbm_spin.hpp"
+#include "Sampler/metropolis_local_pt.hpp"
+#include "Stats/mc_stats.hpp"
+
+// These tests are meant to be run on several MPI processes as well, e.g.
+// `mpirun -n 2 test-sampler`.
+
+TEST_CASE("distributed temperature ladders", "[sampler]") {
+  int rank, size;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+  netket::Hypercube graph(4, 1, true);
+  auto hilbert = std::make_shared<netket::Spin>(graph, 0.5);
+  netket::RbmSpin machine(hilbert, 0, 1);
+  machine.InitRandomPars(0.8, 1234u);
+
+  const int nreplicas = 2;
+  netket::MetropolisLocalPt sampler(machine, nreplicas);
+  sampler.Seed(5678);
+  REQUIRE(!sampler.SharesChains());
+  sampler.SetDistributed(true);
+  REQUIRE(sampler.SharesChains());
+  REQUIRE(sampler.Ladder().Betas().size() ==
+          static_cast<std::size_t>(nreplicas * size));
+
+  // Mismatches are only checked after the sweeps: a process leaving the test
+  // early would block the others in the next collective call
+  int ladder_mismatches = 0;
+  int log_val_mismatches = 0;
+  int target_mismatches = 0;
+
+  // The exchanges decided on the root are replayed by every process, so the
+  // local temperatures of all processes form the whole ladder
+  const auto check_ladder = [&]() {
+    std::vector<double> local(nreplicas);
+    for (int r = 0; r < nreplicas; ++r) {
+      local[r] = sampler.Ladder()[r];
+    }
+    std::vector<double> all(nreplicas * size);
+    MPI_Allgather(local.data(), nreplicas, MPI_DOUBLE, all.data(), nreplicas,
+                  MPI_DOUBLE, MPI_COMM_WORLD);
+    std::sort(all.begin(), all.end(), std::greater<double>());
+    ladder_mismatches += all != sampler.Ladder().Betas();
+  };
+
+  const int nv = machine.Nvisible();
+  std::map<std::vector<double>, double> counts;
+  const int nsweeps = 20000;
+  Eigen::VectorXcd local_values(nsweeps);
+  for (int sweep = 0; sweep < 500; ++sweep) {
+    sampler.Sweep();
+  }
+  for (int sweep = 0; sweep < nsweeps; ++sweep) {
+    sampler.Sweep();
+    if (sweep % 1000 == 0) {
+      check_ladder();
+    }
+
+    const auto state = sampler.CurrentState();
+    const Eigen::VectorXd v = state.first.row(0);
+    log_val_mismatches +=
+        std::abs(state.second(0) - machine.LogValSingle(v, netket::any{})) >
+        1e-8;
+
+    // All processes return the configuration at beta = 1
+    Eigen::VectorXd root_v = v;
+    MPI_Bcast(root_v.data(), nv, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+    target_mismatches += root_v != v;
+
+    counts[std::vector<double>(v.data(), v.data() + nv)] += 1;
+    local_values(sweep) = v.sum();
+  }
+
+  const auto sum_over_processes = [](int count) {
+    int total;
+    MPI_Allreduce(&count, &total, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+    return total;
+  };
+  ladder_mismatches = sum_over_processes(ladder_mismatches);
+  log_val_mismatches = sum_over_processes(log_val_mismatches);
+  target_mismatches = sum_over_processes(target_mismatches);
+  REQUIRE(ladder_mismatches == 0);
+  REQUIRE(log_val_mismatches == 0);
+  REQUIRE(target_mismatches == 0);
+
+  SECTION("Samples follow |psi|^2") {
+    std::vector<double> probabilities(1 << nv);
+    double norm = 0;
+    for (int k = 0; k < (1 << nv); ++k) {
+      Eigen::VectorXd v(nv);
+      for (int i = 0; i < nv; ++i) {
+        v(i) = (k >> i & 1) ? 1 : -1;
+      }
+      probabilities[k] =
+          std::norm(std::exp(machine.LogValSingle(v, netket::any{})));
+      norm += probabilities[k];
+    }
+    double distance = 0;
+    for (int k = 0; k < (1 << nv); ++k) {
+      std::vector<double> v(nv);
+      for (int i = 0; i < nv; ++i) {
+        v[i] = (k >> i & 1) ? 1 : -1;
+      }
+      distance += std::abs(probabilities[k] / norm - counts[v] / nsweeps);
+    }
+    REQUIRE(distance / 2 < 0.05);
+  }
+
+  SECTION("The shared chain is counted once") {
+    // Like a single chain on a single process
+    const auto stats = netket::Statistics(local_values, 1, true);
+    REQUIRE(std::isnan(stats.error_of_mean));
+
+    // Blocks of the chain are compared with each other instead
+    const int nblocks = 8;
+    const int length = nsweeps / nblocks;
+    Eigen::VectorXcd blocks(nsweeps);
+    for (int b = 0; b < nblocks; ++b) {
+      for (int i = 0; i < length; ++i) {
+        blocks(i * nblocks + b) = local_values(b * length + i);
+      }
+    }
+    const auto shared = netket::Statistics(blocks, nblocks, true);
+    REQUIRE(shared.error_of_mean > 0);
+    REQUIRE(shared.R > 0.9);
+    REQUIRE(shared.R < 1.1);
+  }
+
+  sampler.SetDistributed(false);
+  REQUIRE(!sampler.SharesChains());
+}
+
+TEST_CASE("setting the visible units of a distributed ladder", "[sampler]") {
+  netket::Hypercube graph(4, 1, true);
+  auto hilbert = std::make_shared<netket::Spin>(graph, 0.5);
+  netket::RbmSpin machine(hilbert, 0, 1);
+  machine.InitRandomPars(0.8, 1234u);
+
+  netket::MetropolisLocalPt sampler(machine, 2);
+  sampler.Seed(5678);
+  sampler.SetDistributed(true);
+  for (int sweep = 0; sweep < 10; ++sweep) {
+    sampler.Sweep();
+  }
+
+  // The replica at beta = 1 is set, wherever it is
+  netket::RowMatrix<double> v(1, machine.Nvisible());
+  v << 1, -1, 1, -1;
+  sampler.SetVisible(v);
+  const auto state = sampler.CurrentState();
+  REQUIRE(state.first == v);
+  const Eigen::VectorXd expected = v.row(0).transpose();
+  REQUIRE(std::abs(state.second(0) -
+                   machine.LogValSingle(expected, netket::any{})) < 1e-8);
+}
@@ -109,3 +109,47 @@ TEST_CASE("stats miscellanea", "[stats]") {
 
   SECTION("Correlation times are consinstent") { REQUIRE(taucorr2 > taucorr1); }
 }
+
+// Samples of `number_chains` Markov chains of AR(1) processes
+// x' = phi * x + noise, stored as Statistics() expects them: one value of
+// every chain per step.
+Eigen::VectorXcd AutoRegressiveChains(double phi, netket::Index number_chains,
+                                      netket::Index length, std::mt19937 &gen) {
+  std::normal_distribution<double> noise;
+  Eigen::VectorXd x(number_chains);
+  // Starts from the stationary distribution
+  for (auto c = netket::Index{0}; c < number_chains; ++c) {
+    x(c) = noise(gen) / std::sqrt(1. - phi * phi);
+  }
+  Eigen::VectorXcd values(number_chains * length);
+  for (auto i = netket::Index{0}; i < length; ++i) {
+    values.segment(i * number_chains, number_chains) = x.cast<netket::Complex>();
+    for (auto c = netket::Index{0}; c < number_chains; ++c) {
+      x(c) = phi * x(c) + noise(gen);
+    }
+  }
+  return values;
+}
+
+TEST_CASE("autocorrelation time of Markov chains", "[stats]") {
+  std::mt19937 gen(1234);
+  const netket::Index number_chains = 256;
+  const netket::Index length = 1000;
+
+  SECTION("Independent samples") {
+    const auto stats = netket::Statistics(
+        AutoRegressiveChains(0., number_chains, length, gen), number_chains);
+    REQUIRE(stats.correlation >= 0.);
+    REQUIRE(stats.correlation < 0.15);
+    REQUIRE(stats.variance == Approx(1.).epsilon(0.02));
+  }
+
+  SECTION("AR(1) process") {
+    // 1 + 2τ = (1 + phi) / (1 - phi)
+    const double phi = 0.8;
+    const double tau = phi / (1. - phi);
+    const auto stats = netket::Statistics(
+        AutoRegressiveChains(phi, number_chains, length, gen), number_chains);
+    REQUIRE(stats.correlation == Approx(tau).epsilon(0.15));
+  }
+}
@@ -22,15 +22,16 @@ class CxxMachine(Machine):
         """
         raise NotImplementedError
 
-    def der_log(self, v):
-        r"""Returns the gradient of the logarithm of the wave function for
-        a batch of visible configurations `v`.
+    def der_log(self, v, out=None):
+        r"""Computes the gradient of the logarithm of the wave function for
+        a batch of visible configurations `v` and stores the result in `out`.
 
         Subclasses should implement this function.
 
         Args:
             x: 1D vector of `float` of size `self.n_visible` or a 2D matrix of
             `float` of size `(batch_size, self.n_visible)`.
+            out: Destination matrix of size `(batch_size, self.n_par)`.
         """
         raise NotImplementedError
 